@@ -1,9 +1,13 @@
 ﻿#include "FlaxFontEngineInterface.h"
 #include "FlaxRenderInterface.h"
+#include "RmlUiPlugin.h"
+#include "RmlUiFontAtlasAsset.h"
+#include "RmlUiProfiler.h"
 
 #include <ThirdParty/RmlUi/Core/Core.h>
 #include <ThirdParty/RmlUi/Core/FontEffect.h>
 #include <ThirdParty/RmlUi/Core/FontGlyph.h>
+#include <ThirdParty/RmlUi/Core/StringUtilities.h>
 
 #include <Engine/Content/Assets/Texture.h>
 #include <Engine/Content/Content.h>
@@ -13,6 +17,9 @@
 #include <Engine/Core/Math/Color32.h>
 #include <Engine/Core/Math/Rectangle.h>
 #include <Engine/Core/Math/Vector2.h>
+#include <Engine/Graphics/GPUContext.h>
+#include <Engine/Graphics/GPUDevice.h>
+#include <Engine/Graphics/PixelFormatExtensions.h>
 #include <Engine/Graphics/Textures/GPUTexture.h>
 #include <Engine/Render2D/Font.h>
 #include <Engine/Render2D/FontAsset.h>
@@ -25,10 +32,17 @@
 
 #define EFFECT_FONT_ATLAS_SIZE 512
 
+// Signed distance field glyphs are rasterized once at the base size and scaled to all requested sizes
+#define SDF_FONT_ATLAS_SIZE 1024
+#define SDF_BASE_SIZE 48
+#define SDF_SPREAD 8
+
 struct FontEffectLayer
 {
     const Rml::FontEffect* effect;
     Dictionary<Char, FontCharacterEntry> characters;
+    Float2 sdfParams;
+    Float2 sdfOffset;
 };
 
 struct FontEffect
@@ -45,6 +59,42 @@ struct FontFace
     int fontAssetIndex;
 };
 
+struct AtlasDirtyRect
+{
+    const FontTextureAtlasSlot* anchor;
+    int32 minX;
+    int32 minY;
+    int32 maxX;
+    int32 maxY;
+};
+
+struct SdfGlyph
+{
+    FontCharacterEntry entry;
+    FontCharacterEntry sdfEntry;
+};
+
+struct SdfFont
+{
+    Font* font;
+    Dictionary<Char, SdfGlyph> glyphs;
+};
+
+struct SdfFontFace
+{
+    SdfFont* sdfFont;
+    int size;
+    float scale;
+    Float2 sdfParams;
+};
+
+struct SdfTexture
+{
+    int atlasIndex;
+    Float2 params;
+    Rml::Texture* texture;
+};
+
 namespace
 {
     Array<AssetReference<FontTextureAtlas>> EffectAtlases(4);
@@ -55,8 +105,19 @@ namespace
     Dictionary<StringAnsi, Array<FontFace>> FontFaces(32);
     StringAnsi FallbackFontFaceFamily;
     Array<AssetReference<FontAsset>> FontAssets;
-    Dictionary<Font*, Rml::FontMetrics> FontMetrics(32);
+    Dictionary<Rml::FontFaceHandle, Rml::FontMetrics> FontMetrics(32);
     Array<FontEffect> FontEffects(8);
+    bool UseSdf = false;
+    Array<AssetReference<FontTextureAtlas>> SdfAtlases(2);
+    Array<SdfTexture> SdfTextures(8);
+    Array<Rml::String> SdfTextureNames(8);
+    Array<SdfFont*> SdfFonts(8);
+    Array<SdfFontFace*> SdfFontFaces(32);
+    bool UseTabularDigits = false;
+    Dictionary<FontTextureAtlas*, AtlasDirtyRect> AtlasDirtyRects(8);
+    Dictionary<uint64, GPUTexture*> AtlasStagingTextures(8);
+    Dictionary<Font*, int16> TabularDigitAdvances(8);
+    FlaxFontEngineStats Stats = {};
 }
 
 // RmlUi textures can be identified only by their source names, generate and cache names for the generated atlases
@@ -81,12 +142,30 @@ Rml::String GetAtlasTextureNameHandle(int index)
     return AtlasTextureNames[index];
 }
 
+Rml::String GetSdfTextureNameHandle(int index)
+{
+    if (SdfTextureNames.Count() <= index)
+    {
+        StringAnsi handleName = StringAnsi::Format("GEN_SDF_ATLAS_{0}", index);
+        SdfTextureNames.Add(Rml::String(handleName.Get(), handleName.Length()));
+    }
+    return SdfTextureNames[index];
+}
+
 FlaxFontEngineInterface::FlaxFontEngineInterface()
 {
+    UseSdf = RmlUiSettings::Get()->TextRenderMode == RmlUiTextRenderMode::SignedDistanceField;
+    UseTabularDigits = RmlUiSettings::Get()->TabularDigits;
+
     // Value of 0 is invalid handle, reserve it
     FontEffects.Add({0, {0}});
 }
 
+bool FlaxFontEngineInterface::IsUsingSignedDistanceField() const
+{
+    return UseSdf;
+}
+
 void FlaxFontEngineInterface::ReleaseFontResources()
 {
     FontAssets.Clear();
@@ -96,13 +175,107 @@ void FlaxFontEngineInterface::ReleaseFontResources()
             atlas->DeleteObject();
     EffectAtlases.Clear();
 
+    for (const auto& atlas : SdfAtlases)
+        if (atlas->IsLoaded())
+            atlas->DeleteObject();
+    SdfAtlases.Clear();
+
+    for (const auto& sdfTexture : SdfTextures)
+        Delete(sdfTexture.texture);
+    SdfTextures.Clear();
+    SdfFonts.ClearDelete();
+    SdfFontFaces.ClearDelete();
+
+    AtlasDirtyRects.Clear();
+    for (const auto& e : AtlasStagingTextures)
+        SAFE_DELETE_GPU_RESOURCE(e.Value);
+    AtlasStagingTextures.Clear();
+
     AtlasTextures.ClearDelete();
     EffectAtlasTextures.ClearDelete();
     FontMetrics.Clear();
+    TabularDigitAdvances.Clear();
     FontEffects.Clear();
     FontFaces.Clear();
 }
 
+// Distance values are normalized so the glyph edge lies at 0.5 and the spread covers the whole [0, 1] range.
+// Returns the edge threshold and the half-width of the edge transition for the scaled glyph.
+Float2 GetSdfParams(float scale, float dilation, bool soft)
+{
+    const float pixelDistance = 1.0f / (scale * SDF_SPREAD * 2.0f);
+    const float expand = Math::Clamp(dilation * pixelDistance, 0.0f, Math::Max(0.5f - pixelDistance, 0.0f));
+    if (soft)
+        return Float2(0.5f - expand * 0.5f, (expand + pixelDistance) * 0.5f);
+    return Float2(0.5f - expand, pixelDistance * 0.5f);
+}
+
+SdfFont* GetSdfFont(FontAsset* fontAsset)
+{
+    Font* font = fontAsset->CreateFont((float)SDF_BASE_SIZE * DPI_ADJUSTMENT);
+    if (font == nullptr)
+        return nullptr;
+
+    for (SdfFont* existingFont : SdfFonts)
+    {
+        if (existingFont->font == font)
+            return existingFont;
+    }
+
+    SdfFont* sdfFont = New<SdfFont>();
+    sdfFont->font = font;
+    SdfFonts.Add(sdfFont);
+    return sdfFont;
+}
+
+SdfFontFace* GetSdfFontFace(FontAsset* fontAsset, int size)
+{
+    SdfFont* sdfFont = GetSdfFont(fontAsset);
+    if (sdfFont == nullptr)
+        return nullptr;
+
+    for (SdfFontFace* existingFace : SdfFontFaces)
+    {
+        if (existingFace->sdfFont == sdfFont && existingFace->size == size)
+            return existingFace;
+    }
+
+    SdfFontFace* face = New<SdfFontFace>();
+    face->sdfFont = sdfFont;
+    face->size = size;
+    face->scale = (float)size / (float)SDF_BASE_SIZE;
+    face->sdfParams = GetSdfParams(face->scale, 0.0f, false);
+    SdfFontFaces.Add(face);
+    return face;
+}
+
+// Returns the font used for glyph metrics and the scale of the metrics for the face handle
+Font* GetFaceFont(Rml::FontFaceHandle handle, float& scale)
+{
+    if (UseSdf)
+    {
+        auto face = (SdfFontFace*)handle;
+        scale = face->scale;
+        return face->sdfFont->font;
+    }
+    scale = 1.0f;
+    return (Font*)handle;
+}
+
+bool GetSdfCharacter(SdfFont* sdfFont, Char c, FontCharacterEntry& entry, FontCharacterEntry& sdfEntry);
+
+// Returns the metrics of the character, distance field faces read them from the cached or baked glyph so the layout doesn't rasterize the base size font into the engine atlas
+void GetFaceCharacter(Rml::FontFaceHandle handle, Char c, FontCharacterEntry& entry)
+{
+    if (UseSdf)
+    {
+        FontCharacterEntry sdfEntry;
+        GetSdfCharacter(((SdfFontFace*)handle)->sdfFont, c, entry, sdfEntry);
+        return;
+    }
+    ((Font*)handle)->GetCharacter(c, entry);
+}
+
 Array<FontFace>* GetFontFacesForFamily(const StringAnsiView& familyName)
 {
     Array<FontFace>* familyFonts = FontFaces.TryGet(familyName);
@@ -176,7 +349,10 @@ bool FlaxFontEngineInterface::LoadFontFace(const Rml::byte* data, int data_size,
 
 Rml::FontFaceHandle FlaxFontEngineInterface::GetFontFaceHandle(const Rml::String& family, Rml::Style::FontStyle style, Rml::Style::FontWeight weight, int size)
 {
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.GetFontFaceHandle");
+
     const StringAnsiView familyName(family.c_str(), (int32)family.length());
+    RMLUI_PROFILE_DETAIL(familyName);
     Array<FontFace>* fontFaces = GetFontFacesForFamily(familyName);
     int fallbackIndex = -1;
     int fallbackForBoldIndex = -1;
@@ -221,14 +397,68 @@ Rml::FontFaceHandle FlaxFontEngineInterface::GetFontFaceHandle(const Rml::String
     if (fontAsset == nullptr)
         return Rml::FontFaceHandle();
 
-    Font* font;
+    FontAsset* faceAsset = fontAsset.Get();
     if (fallbackForBoldIndex >= 0)
-        font = fontAsset->GetBold()->CreateFont((float)size * DPI_ADJUSTMENT);
-    else
-        font = fontAsset->CreateFont((float)size * DPI_ADJUSTMENT);
+        faceAsset = faceAsset->GetBold();
+
+    if (UseSdf)
+        return (Rml::FontFaceHandle)GetSdfFontFace(faceAsset, size);
+
+    Font* font = faceAsset->CreateFont((float)size * DPI_ADJUSTMENT);
     return (Rml::FontFaceHandle)font;
 }
 
+// Effects can't be identified through the public RmlUi API, so the effect is probed with a filled square glyph
+// to find out whether it produces hard (outline) or smooth (glow, blur) edges along its sides.
+bool IsSoftFontEffect(const Rml::FontEffect* effect, const Rml::FontGlyph& glyph, Rml::Vector2i dimensions)
+{
+    if (!effect->HasUniqueTexture())
+        return false;
+
+    static Array<byte> probeBytes;
+    probeBytes.Resize(dimensions.x * dimensions.y * 4);
+    Platform::MemoryClear(probeBytes.Get(), probeBytes.Count());
+    effect->GenerateGlyphTexture(probeBytes.Get(), dimensions, dimensions.x * 4, glyph);
+
+    int softPixels = 0;
+    const int y = dimensions.y / 2;
+    for (int x = 0; x < dimensions.x; x++)
+    {
+        const byte alpha = probeBytes[(y * dimensions.x + x) * 4 + 3];
+        if (alpha > 0 && alpha < 255)
+            softPixels++;
+    }
+    return softPixels > 2;
+}
+
+void PrepareSdfEffectLayer(const SdfFontFace* face, FontEffectLayer& layer)
+{
+    constexpr int probeSize = 16;
+    static byte probeBitmap[probeSize * probeSize];
+    Platform::MemorySet(probeBitmap, 255, sizeof(probeBitmap));
+
+    Rml::FontGlyph glyph;
+    glyph.color_format = Rml::ColorFormat::A8;
+    glyph.dimensions = Rml::Vector2i(probeSize, probeSize);
+    glyph.bitmap_dimensions = Rml::Vector2i(probeSize, probeSize);
+    glyph.advance = probeSize;
+    glyph.bitmap_data = probeBitmap;
+
+    // Measure how much the effect expands and offsets the glyph
+    Rml::Vector2i origin(0, 0);
+    Rml::Vector2i dimensions(probeSize, probeSize);
+    if (!layer.effect->GetGlyphMetrics(origin, dimensions, glyph))
+    {
+        layer.sdfParams = Float2::Zero;
+        layer.sdfOffset = Float2::Zero;
+        return;
+    }
+
+    const float expand = (float)(dimensions.x - probeSize) * 0.5f;
+    layer.sdfOffset = Float2((float)origin.x + expand, (float)origin.y + expand);
+    layer.sdfParams = GetSdfParams(face->scale, expand, IsSoftFontEffect(layer.effect, glyph, dimensions));
+}
+
 Rml::FontEffectsHandle FlaxFontEngineInterface::PrepareFontEffects(Rml::FontFaceHandle font_handle, const Rml::FontEffectList& font_effects)
 {
     if (font_effects.empty())
@@ -263,6 +493,8 @@ Rml::FontEffectsHandle FlaxFontEngineInterface::PrepareFontEffects(Rml::FontFace
     {
         FontEffectLayer& layer = fontEffect.layers[i];
         layer.effect = font_effects[i].get();
+        if (UseSdf)
+            PrepareSdfEffectLayer((SdfFontFace*)font_handle, layer);
     }
 
     const Rml::FontEffectsHandle effectsHandle(FontEffects.Count());
@@ -299,25 +531,80 @@ float FlaxFontEngineInterface::GetUnderline(Rml::FontFaceHandle handle, float& t
 
 const Rml::FontMetrics& FlaxFontEngineInterface::GetFontMetrics(Rml::FontFaceHandle handle)
 {
-    auto font = (Font*)handle;
-    if (!FontMetrics.ContainsKey(font))
+    if (!FontMetrics.ContainsKey(handle))
     {
+        float scale;
+        Font* font = GetFaceFont(handle, scale);
+
         Rml::FontMetrics metrics;
-        metrics.ascent = (float)font->GetAscender();
-        metrics.descent = -(float)font->GetDescender();
-        metrics.line_spacing = (float)font->GetHeight();
-        metrics.size = (int)(font->GetSize() / DPI_ADJUSTMENT); // The original font size is multiplied by DPI
+        metrics.ascent = (float)font->GetAscender() * scale;
+        metrics.descent = -(float)font->GetDescender() * scale;
+        metrics.line_spacing = (float)font->GetHeight() * scale;
+        if (UseSdf)
+            metrics.size = ((SdfFontFace*)handle)->size;
+        else
+            metrics.size = (int)(font->GetSize() / DPI_ADJUSTMENT); // The original font size is multiplied by DPI
         metrics.underline_position = 0; // FIXME: -face->underline_position
         metrics.underline_thickness = 2; // FIXME: (float)face->underline_thickness
 
         FontCharacterEntry entry;
-        font->GetCharacter('x', entry);
-        metrics.x_height = entry.Height;
+        GetFaceCharacter(handle, 'x', entry);
+        metrics.x_height = (float)entry.Height * scale;
 
-        FontMetrics.Add(font, metrics);
+        FontMetrics.Add(handle, metrics);
     }
 
-    return FontMetrics[font];
+    return FontMetrics[handle];
+}
+
+// Strings are decoded from UTF-8, Flax fonts index the characters by UTF-16 code units so the characters outside of the basic multilingual plane are replaced
+Char GetFontCharacter(Rml::Character character)
+{
+    return (uint32)character > 0xFFFF ? (Char)0xFFFD : (Char)character;
+}
+
+bool IsTabularDigit(Char c)
+{
+    return UseTabularDigits && c >= '0' && c <= '9';
+}
+
+int16 GetTabularDigitAdvance(Rml::FontFaceHandle handle)
+{
+    // Distance field faces share the advance of the base size font
+    float scale;
+    Font* font = GetFaceFont(handle, scale);
+    int16 advance;
+    if (!TabularDigitAdvances.TryGet(font, advance))
+    {
+        advance = 0;
+        FontCharacterEntry entry;
+        for (Char c = '0'; c <= '9'; c++)
+        {
+            GetFaceCharacter(handle, c, entry);
+            advance = Math::Max(advance, entry.AdvanceX);
+        }
+        TabularDigitAdvances.Add(font, advance);
+    }
+    return advance;
+}
+
+// Returns the advance of the character, tabular digits share the advance of the widest digit and are centered within it
+float GetCharacterAdvance(Rml::FontFaceHandle handle, const FontCharacterEntry& entry, float& glyphOffset)
+{
+    glyphOffset = 0.0f;
+    if (!IsTabularDigit(entry.Character))
+        return (float)entry.AdvanceX;
+
+    const int16 advance = GetTabularDigitAdvance(handle);
+    glyphOffset = (float)(advance - entry.AdvanceX) * 0.5f;
+    return (float)advance;
+}
+
+float GetCharacterKerning(Font* font, const FontCharacterEntry& previous, const FontCharacterEntry& entry)
+{
+    if (!previous.IsValid || IsTabularDigit(previous.Character) || IsTabularDigit(entry.Character))
+        return 0.0f;
+    return (float)font->GetKerning(previous.Character, entry.Character);
 }
 
 #if USE_RMLUI_6_0
@@ -328,29 +615,30 @@ int FlaxFontEngineInterface::GetStringWidth(Rml::FontFaceHandle handle, const Rm
 {
     float letter_spacing = 0.0f;
 #endif
-    const StringAnsiView text(str.c_str(), (int32)str.length());
-    auto font = (Font*)handle;
+    float scale;
+    Font* font = GetFaceFont(handle, scale);
     FontCharacterEntry entry, previous;
     float lineWidth = 0.0f;
 
     if (prior_character != Rml::Character::Null)
     {
-        const Char c = (Char)prior_character;
+        const Char c = GetFontCharacter(prior_character);
         if (c != '\n')
-            font->GetCharacter(c, previous);
+            GetFaceCharacter(handle, c, previous);
     }
 
-    for (int32 charIndex = 0; charIndex < text.Length(); charIndex++)
+    for (Rml::StringIteratorU8 it(str); it; ++it)
     {
-        const Char c = text[charIndex];
+        const Char c = GetFontCharacter(*it);
         if (c == '\n')
             continue;
 
-        font->GetCharacter(c, entry);
+        GetFaceCharacter(handle, c, entry);
 
-        if (!StringUtils::IsWhitespace(c) && previous.IsValid)
-            lineWidth += (float)font->GetKerning(previous.Character, entry.Character);
-        lineWidth += (float)entry.AdvanceX + letter_spacing;
+        float glyphOffset;
+        if (!StringUtils::IsWhitespace(c))
+            lineWidth += GetCharacterKerning(font, previous, entry) * scale;
+        lineWidth += GetCharacterAdvance(handle, entry, glyphOffset) * scale + letter_spacing;
         previous = entry;
     }
     return (int)lineWidth;
@@ -368,9 +656,10 @@ bool FontAtlasTextureCallback(const Rml::String& name, Rml::UniquePtr<const byte
     // RmlUi requests data to be generated here, but we have already copied the glyph data to the texture earlier,
     // so we prepare the texture handle pointing to the atlas texture in this callback instead of generating anything.
 
-    PROFILE_CPU_NAMED("RmlUi.FontAtlasTextureCallback");
+    RMLUI_PROFILE_CPU(PerFrame, "RmlUi.FontAtlasTextureCallback");
 
     FontTextureAtlas* atlas = nullptr;
+    const SdfTexture* sdfTexture = nullptr;
     int32 fontAtlasIndex = 0;
     bool isFont = true;
     if (EffectAtlasTextureNames.Find(name, fontAtlasIndex))
@@ -378,6 +667,11 @@ bool FontAtlasTextureCallback(const Rml::String& name, Rml::UniquePtr<const byte
         atlas = EffectAtlases[fontAtlasIndex];
         isFont = false;
     }
+    else if (SdfTextureNames.Find(name, fontAtlasIndex))
+    {
+        sdfTexture = &SdfTextures[fontAtlasIndex];
+        atlas = SdfAtlases[sdfTexture->atlasIndex];
+    }
     else if (AtlasTextureNames.Find(name, fontAtlasIndex))
         atlas = FontManager::GetAtlas(fontAtlasIndex);
     if (atlas == nullptr)
@@ -385,9 +679,17 @@ bool FontAtlasTextureCallback(const Rml::String& name, Rml::UniquePtr<const byte
 
     auto renderInterface = (FlaxRenderInterface*)render_interface;
     GPUTexture* texture = atlas->GetTexture();
-    texture_handle = renderInterface->GetTextureHandle(texture);
-    if (!texture_handle)
-        texture_handle = renderInterface->RegisterTexture(texture, isFont);
+    if (sdfTexture != nullptr)
+    {
+        // Distance field atlases are shared by multiple handles which differ in the edge parameters
+        texture_handle = renderInterface->RegisterSdfTexture(texture, sdfTexture->params);
+    }
+    else
+    {
+        texture_handle = renderInterface->GetTextureHandle(texture);
+        if (!texture_handle)
+            texture_handle = renderInterface->RegisterTexture(texture, isFont);
+    }
 
     const Float2 atlasTextureSize = atlas->GetSize();
     texture_dimensions.x = (int)atlasTextureSize.X;
@@ -400,9 +702,8 @@ bool FontAtlasTextureCallback(const Rml::String& name, Rml::UniquePtr<const byte
     renderInterface->AddFontAtlasTextureHandle(texture_handle, (byte*)data.get());
     if (!texture->IsAllocated())
     {
-        // Ensure the backing texture exists
-        auto fontEngineInterface = (FlaxFontEngineInterface*)Rml::GetFontEngineInterface();
-        fontEngineInterface->FlushFontAtlases();
+        // Ensure the backing texture exists, the contents are uploaded in the next flush
+        atlas->EnsureTextureCreated();
     }
 #endif
 
@@ -427,13 +728,13 @@ Rml::Geometry* GetOrAddGeometrySlot(Array<Rml::Geometry>& geometryArray, Rml::Te
     return geometry;
 }
 
-void WriteCharacterRect(Float2 pointer, FontCharacterEntry& entry, Color32 color, Float2 invAtlasSize, Rml::Geometry* geometry)
+void WriteCharacterRect(Float2 pointer, FontCharacterEntry& entry, Color32 color, Float2 invAtlasSize, Rml::Geometry* geometry, float scale = 1.0f)
 {
     // Calculate character size and atlas coordinates
-    const float x = pointer.X + (float)entry.OffsetX;
-    const float y = pointer.Y + (float)-entry.OffsetY;
+    const float x = pointer.X + (float)entry.OffsetX * scale;
+    const float y = pointer.Y + (float)-entry.OffsetY * scale;
 
-    Rectangle charRect(x, y, entry.UVSize.X, entry.UVSize.Y);
+    Rectangle charRect(x, y, entry.UVSize.X * scale, entry.UVSize.Y * scale);
     Float2 charBottomRight = charRect.GetBottomRight();
     Float2 charBottomLeft = charRect.GetBottomLeft();
     Float2 charUpperLeft = charRect.GetUpperLeft();
@@ -487,7 +788,376 @@ void WriteCharacterRect(Float2 pointer, FontCharacterEntry& entry, Color32 color
     indices.push_back(startVertex + 0);
 }
 
+void MarkAtlasDirty(FontTextureAtlas* atlas, const FontTextureAtlasSlot* slot, int32 x, int32 y, int32 width, int32 height)
+{
+    AtlasDirtyRect* rect = AtlasDirtyRects.TryGet(atlas);
+    if (rect == nullptr)
+    {
+        AtlasDirtyRects.Add(atlas, { slot, x, y, x + width, y + height });
+        return;
+    }
+    rect->minX = Math::Min(rect->minX, x);
+    rect->minY = Math::Min(rect->minY, y);
+    rect->maxX = Math::Max(rect->maxX, x + width);
+    rect->maxY = Math::Max(rect->maxY, y + height);
+}
+
+// Adds distance field or effect glyph to the atlases, bitmap glyphs are added by the engine font cache and not counted
+FontTextureAtlasSlot* AddAtlasEntry(Array<AssetReference<FontTextureAtlas>>& atlases, PixelFormat format, int32 atlasSize, int32 width, int32 height, const Array<byte>& data, byte& atlasIndex)
+{
+    Stats.RasterizedGlyphs++;
+
+    // Find space for the glyph in existing atlases
+    for (byte i = 0; i < (byte)atlases.Count(); i++)
+    {
+        FontTextureAtlasSlot* slot = atlases[i]->AddEntry(width, height, data);
+        if (slot != nullptr)
+        {
+            atlasIndex = i;
+            MarkAtlasDirty(atlases[i], slot, slot->X, slot->Y, slot->Width, slot->Height);
+            return slot;
+        }
+    }
+
+    // No space in existing atlases, create a new one
+    atlasIndex = (byte)atlases.Count();
+    AssetReference<FontTextureAtlas> atlas = Content::CreateVirtualAsset<FontTextureAtlas>();
+    atlas->Setup(format, FontTextureAtlas::PaddingStyle::PadWithZero);
+    atlas->Init(atlasSize, atlasSize);
+    atlases.Add(atlas);
+
+    // The whole page is uploaded the first time so the texture contents are initialized
+    FontTextureAtlasSlot* slot = atlas->AddEntry(width, height, data);
+    if (slot != nullptr)
+        MarkAtlasDirty(atlas, slot, 0, 0, atlasSize, atlasSize);
+    return slot;
+}
+
+GPUTexture* GetAtlasStagingTexture(int32 width, int32 height, PixelFormat format)
+{
+    const uint64 key = (uint64)width | ((uint64)height << 16) | ((uint64)format << 32);
+    GPUTexture* texture;
+    if (AtlasStagingTextures.TryGet(key, texture))
+        return texture;
+
+    texture = GPUDevice::Instance->CreateTexture(TEXT("RmlUi.AtlasStaging"));
+    if (texture->Init(GPUTextureDescription::New2D(width, height, format)))
+    {
+        LOG(Error, "RmlUi: Failed to create font atlas staging texture");
+        SAFE_DELETE_GPU_RESOURCE(texture);
+        return nullptr;
+    }
+    AtlasStagingTextures.Add(key, texture);
+    return texture;
+}
+
+// Uploads the modified region of the atlas page through a staging texture and copies it to the atlas texture
+void UploadAtlasRegion(GPUContext* context, FontTextureAtlas* atlas, const AtlasDirtyRect& rect)
+{
+    GPUTexture* texture = atlas->GetTexture();
+    const int32 atlasWidth = texture->Width();
+    const int32 atlasHeight = texture->Height();
+
+    // Staging textures are pooled by power-of-two sizes, the region is moved to fit within the page
+    const int32 width = Math::Min((int32)Math::RoundUpToPowerOf2((uint32)(rect.maxX - rect.minX)), atlasWidth);
+    const int32 height = Math::Min((int32)Math::RoundUpToPowerOf2((uint32)(rect.maxY - rect.minY)), atlasHeight);
+    const int32 x = Math::Min(rect.minX, atlasWidth - width);
+    const int32 y = Math::Min(rect.minY, atlasHeight - height);
+
+    GPUTexture* stagingTexture = GetAtlasStagingTexture(width, height, texture->Format());
+    if (stagingTexture == nullptr)
+        return;
+
+    // The atlas exposes its data only through slots, locate the start of the page from any slot
+    uint32 slotWidth, slotHeight, stride;
+    const byte* slotData = atlas->GetSlotData(rect.anchor, slotWidth, slotHeight, stride);
+    const uint32 bytesPerPixel = PixelFormatExtensions::SizeInBytes(texture->Format());
+    const uint32 padding = atlas->GetPaddingAmount();
+    const byte* atlasData = slotData - (rect.anchor->Y + padding) * stride - (rect.anchor->X + padding) * bytesPerPixel;
+
+    context->UpdateTexture(stagingTexture, 0, 0, atlasData + y * stride + x * bytesPerPixel, stride, stride * height);
+    context->CopyTexture(texture, 0, x, y, 0, stagingTexture, 0);
+}
+
+void InsertGeometryLayers(Rml::GeometryList& geometryList, Array<Rml::Geometry>& geometryBack, Array<Rml::Geometry>& geometryMiddle, Array<Rml::Geometry>& geometryFront)
+{
+    // Cull empty geometry collections from the list
+    for (int i = 0; i < geometryList.size(); i++)
+    {
+        if (!geometryList[i].GetVertices().empty())
+            continue;
+
+        geometryList.erase(geometryList.begin() + i);
+        i--;
+    }
+
+    // Insert the generated geometry to the list layer by layer
+    geometryList.reserve(geometryList.size() + geometryBack.Count() + geometryMiddle.Count() + geometryFront.Count());
+    for (Rml::Geometry& geometry : geometryBack)
+        geometryList.push_back(MoveTemp(geometry));
+    for (Rml::Geometry& geometry : geometryMiddle)
+        geometryList.push_back(MoveTemp(geometry));
+    for (Rml::Geometry& geometry : geometryFront)
+        geometryList.push_back(MoveTemp(geometry));
+}
+
+// Squared distance transform of a sampled function in one dimension (Felzenszwalb and Huttenlocher), linear in the number of samples
+void DistanceTransform1D(const float* f, float* d, int32 count, int32* v, float* z)
+{
+    int32 k = 0;
+    v[0] = 0;
+    z[0] = -MAX_float;
+    z[1] = MAX_float;
+    for (int32 q = 1; q < count; q++)
+    {
+        // Find the lower envelope of the parabolas rooted at the samples
+        float s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+        while (s <= z[k])
+        {
+            k--;
+            s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = MAX_float;
+    }
+
+    k = 0;
+    for (int32 q = 0; q < count; q++)
+    {
+        while (z[k + 1] < (float)q)
+            k++;
+        d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+    }
+}
+
+// Squared distance of each texel to the closest texel where the grid is zero, computed over the columns and then the rows
+void DistanceTransform2D(Array<float>& grid, int32 width, int32 height)
+{
+    const int32 count = Math::Max(width, height);
+    Array<float> f, d, z;
+    Array<int32> v;
+    f.Resize(count);
+    d.Resize(count);
+    z.Resize(count + 1);
+    v.Resize(count);
+
+    for (int32 x = 0; x < width; x++)
+    {
+        for (int32 y = 0; y < height; y++)
+            f[y] = grid[y * width + x];
+        DistanceTransform1D(f.Get(), d.Get(), height, v.Get(), z.Get());
+        for (int32 y = 0; y < height; y++)
+            grid[y * width + x] = d[y];
+    }
+    for (int32 y = 0; y < height; y++)
+    {
+        DistanceTransform1D(grid.Get() + y * width, d.Get(), width, v.Get(), z.Get());
+        Platform::MemoryCopy(grid.Get() + y * width, d.Get(), width * sizeof(float));
+    }
+}
+
+// Generates the signed distance field from the glyph coverage, the output is padded by the spread on each side
+void GenerateSignedDistanceField(const byte* source, int32 sourceWidth, int32 sourceHeight, int32 sourceStride, int32 spread, Array<byte>& output)
+{
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.GenerateSignedDistanceField");
+
+    const int32 width = sourceWidth + spread * 2;
+    const int32 height = sourceHeight + spread * 2;
+    output.Resize(width * height);
+
+    auto isInside = [&](int32 x, int32 y)
+    {
+        if (x < 0 || y < 0 || x >= sourceWidth || y >= sourceHeight)
+            return false;
+        return source[y * sourceStride + x] >= 128;
+    };
+
+    // Distances to the closest inside texel and to the closest outside texel, each texel uses the one on the other side of the glyph edge
+    const float maxValue = (float)(width * width + height * height);
+    Array<float> toInside, toOutside;
+    toInside.Resize(width * height);
+    toOutside.Resize(width * height);
+    for (int32 y = 0; y < height; y++)
+    {
+        for (int32 x = 0; x < width; x++)
+        {
+            const bool inside = isInside(x - spread, y - spread);
+            toInside[y * width + x] = inside ? 0.0f : maxValue;
+            toOutside[y * width + x] = inside ? maxValue : 0.0f;
+        }
+    }
+    DistanceTransform2D(toInside, width, height);
+    DistanceTransform2D(toOutside, width, height);
+
+    const float maxDistanceSqr = (float)(spread * spread);
+    for (int32 y = 0; y < height; y++)
+    {
+        for (int32 x = 0; x < width; x++)
+        {
+            const int32 index = y * width + x;
+            const bool inside = isInside(x - spread, y - spread);
+            const float closestDistanceSqr = Math::Min(inside ? toOutside[index] : toInside[index], maxDistanceSqr);
+
+            // The edge lies halfway between the texel centers
+            float distance = Math::Sqrt(closestDistanceSqr) - 0.5f;
+            if (!inside)
+                distance = -distance;
+            const float value = Math::Saturate(0.5f + distance / (float)(spread * 2));
+            output[index] = (byte)(value * 255.0f + 0.5f);
+        }
+    }
+}
+
+// Rasterizes the glyph at the base size and builds the distance field from it, returns false for empty glyphs
+bool RasterizeSdfCharacter(Font* font, Char c, FontCharacterEntry& entry, Array<byte>& sdfGlyphBytes, int32& sdfGlyphWidth, int32& sdfGlyphHeight)
+{
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.RasterizeGlyph");
 
+    font->GetCharacter(c, entry);
+
+    FontTextureAtlas* fontAtlas = entry.IsValid ? FontManager::GetAtlas(entry.TextureIndex) : nullptr;
+    if (fontAtlas == nullptr || entry.Slot == nullptr || StringUtils::IsWhitespace(c))
+        return false;
+
+    uint32 sourceGlyphWidth, sourceGlyphHeight, sourceGlyphStride;
+    byte* sourceGlyphSlotData = fontAtlas->GetSlotData(entry.Slot, sourceGlyphWidth, sourceGlyphHeight, sourceGlyphStride);
+    if (sourceGlyphWidth == 0 || sourceGlyphHeight == 0)
+        return false;
+
+    GenerateSignedDistanceField(sourceGlyphSlotData, (int32)sourceGlyphWidth, (int32)sourceGlyphHeight, (int32)sourceGlyphStride, SDF_SPREAD, sdfGlyphBytes);
+    sdfGlyphWidth = (int32)sourceGlyphWidth + SDF_SPREAD * 2;
+    sdfGlyphHeight = (int32)sourceGlyphHeight + SDF_SPREAD * 2;
+    return true;
+}
+
+void AddSdfGlyph(SdfFont* sdfFont, const FontCharacterEntry& entry, const Array<byte>& sdfGlyphBytes, int32 sdfGlyphWidth, int32 sdfGlyphHeight, SdfGlyph& glyph)
+{
+    glyph.entry = entry;
+    glyph.sdfEntry = entry;
+    glyph.sdfEntry.IsValid = false;
+    if (sdfGlyphWidth > 0 && sdfGlyphHeight > 0)
+    {
+        byte sdfAtlasIndex = 0;
+        FontTextureAtlasSlot* slot = AddAtlasEntry(SdfAtlases, PixelFormat::R8_UNorm, SDF_FONT_ATLAS_SIZE, sdfGlyphWidth, sdfGlyphHeight, sdfGlyphBytes, sdfAtlasIndex);
+        if (slot)
+        {
+            FontCharacterEntry& sdfEntry = glyph.sdfEntry;
+            const uint32 padding = SdfAtlases[sdfAtlasIndex]->GetPaddingAmount();
+            sdfEntry.IsValid = true;
+            sdfEntry.TextureIndex = sdfAtlasIndex;
+            sdfEntry.UV.X = static_cast<float>(slot->X + padding);
+            sdfEntry.UV.Y = static_cast<float>(slot->Y + padding);
+            sdfEntry.UVSize.X = static_cast<float>(slot->Width - 2 * padding);
+            sdfEntry.UVSize.Y = static_cast<float>(slot->Height - 2 * padding);
+            sdfEntry.Slot = slot;
+            sdfEntry.OffsetX -= (int16)SDF_SPREAD;
+            sdfEntry.OffsetY += (int16)SDF_SPREAD;
+        }
+        else
+            LOG(Error, "RmlUi: Failed to add distance field glyph to font atlas");
+    }
+    sdfFont->glyphs.Add(entry.Character, glyph);
+}
+
+bool GetSdfCharacter(SdfFont* sdfFont, Char c, FontCharacterEntry& entry, FontCharacterEntry& sdfEntry)
+{
+    SdfGlyph glyph;
+    if (!sdfFont->glyphs.TryGet(c, glyph))
+    {
+        static Array<byte> sdfGlyphBytes;
+        int32 sdfGlyphWidth = 0, sdfGlyphHeight = 0;
+        if (!RasterizeSdfCharacter(sdfFont->font, c, entry, sdfGlyphBytes, sdfGlyphWidth, sdfGlyphHeight))
+            sdfGlyphWidth = sdfGlyphHeight = 0;
+        entry.Character = c;
+        AddSdfGlyph(sdfFont, entry, sdfGlyphBytes, sdfGlyphWidth, sdfGlyphHeight, glyph);
+    }
+
+    entry = glyph.entry;
+    sdfEntry = glyph.sdfEntry;
+    return sdfEntry.IsValid;
+}
+
+Rml::Texture* GetSdfTexture(int atlasIndex, const Float2& params)
+{
+    for (const SdfTexture& sdfTexture : SdfTextures)
+    {
+        if (sdfTexture.atlasIndex == atlasIndex && sdfTexture.params == params)
+            return sdfTexture.texture;
+    }
+
+    // Texture data already exists, the callback only assigns the handle pointing to this atlas with the edge parameters
+    SdfTexture sdfTexture;
+    sdfTexture.atlasIndex = atlasIndex;
+    sdfTexture.params = params;
+    sdfTexture.texture = New<Rml::Texture>();
+    sdfTexture.texture->Set(GetSdfTextureNameHandle(SdfTextures.Count()), FontAtlasTextureCallback);
+    SdfTextures.Add(sdfTexture);
+    return sdfTexture.texture;
+}
+
+int GenerateStringSdf(SdfFontFace* face, FontEffect* fontEffect, const Rml::String& str, const Rml::Vector2f& position, Color32 color, float letter_spacing, Rml::GeometryList& geometryList)
+{
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.GenerateStringSdf");
+
+    static Array<Rml::Geometry> geometryBack;
+    static Array<Rml::Geometry> geometryMiddle;
+    static Array<Rml::Geometry> geometryFront;
+    geometryBack.Resize(0);
+    geometryMiddle.Resize(0);
+    geometryFront.Resize(0);
+
+    Font* font = face->sdfFont->font;
+    const float scale = face->scale;
+    FontCharacterEntry entry, sdfEntry, previousEntry;
+    float pointerX = position.x;
+    for (Rml::StringIteratorU8 it(str); it; ++it)
+    {
+        const Char c = GetFontCharacter(*it);
+        if (c == '\n')
+            continue;
+
+        const bool hasGlyph = GetSdfCharacter(face->sdfFont, c, entry, sdfEntry);
+
+        const bool isWhitespace = StringUtils::IsWhitespace(c);
+        if (!isWhitespace)
+            pointerX += GetCharacterKerning(font, previousEntry, entry) * scale;
+        float glyphOffset;
+        const float advance = GetCharacterAdvance((Rml::FontFaceHandle)face, entry, glyphOffset);
+        Float2 characterPosition(pointerX + glyphOffset * scale, position.y);
+        pointerX += advance * scale + letter_spacing;
+        previousEntry = entry;
+
+        if (isWhitespace || !hasGlyph)
+            continue;
+
+        const Float2 invAtlasSize = 1.0f / SdfAtlases[sdfEntry.TextureIndex]->GetSize();
+        Rml::Geometry* geometry = GetOrAddGeometrySlot(geometryMiddle, GetSdfTexture(sdfEntry.TextureIndex, face->sdfParams));
+        WriteCharacterRect(characterPosition, sdfEntry, color, invAtlasSize, geometry, scale);
+
+        // Font effects reuse the same distance field glyph, only the edge parameters and the offset differ
+        for (auto& layer : fontEffect->layers)
+        {
+            if (layer.sdfParams.IsZero())
+                continue;
+
+            const Rml::FontEffect* fontEffectLayer = layer.effect;
+            Array<Rml::Geometry>& geometryLayer = fontEffectLayer->GetLayer() == Rml::FontEffect::Layer::Back ? geometryBack : geometryFront;
+
+            // Multiply layer color with the text color
+            Rml::Colourb layerColor = fontEffectLayer->GetColour();
+            Color32 effectColor = Color32(Color(Color32(layerColor.red, layerColor.green, layerColor.blue, layerColor.alpha)) * Color(color));
+
+            Rml::Geometry* geometryEffect = GetOrAddGeometrySlot(geometryLayer, GetSdfTexture(sdfEntry.TextureIndex, layer.sdfParams));
+            WriteCharacterRect(characterPosition + layer.sdfOffset, sdfEntry, effectColor, invAtlasSize, geometryEffect, scale);
+        }
+    }
+
+    InsertGeometryLayers(geometryList, geometryBack, geometryMiddle, geometryFront);
+
+    return (int)pointerX;
+}
 
 #if USE_RMLUI_6_0
 int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::FontEffectsHandle font_effects_handle, const Rml::String& str, const Rml::Vector2f& position, const Rml::Colourb& colour, float opacity, float letter_spacing, Rml::GeometryList& geometryList)
@@ -497,12 +1167,14 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
 {
     float letter_spacing = 0.0f;
 #endif
-    const StringAnsiView text(str.c_str(), (int32)str.length());
-    if (text.Length() == 0)
+    if (str.empty())
         return 0;
 
-    PROFILE_CPU_NAMED("RmlUi.GenerateString");
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.GenerateString");
 
+    const bool timed = RmlUiProfileScope::IsEnabled(RmlUiInstrumentationLevel::PerDraw);
+    const double startTime = timed ? Platform::GetTimeSeconds() : 0.0;
+    Stats.GeneratedStrings++;
     static Array<Rml::Geometry> geometryBack;
     static Array<Rml::Geometry> geometryMiddle;
     static Array<Rml::Geometry> geometryFront;
@@ -510,9 +1182,17 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
     geometryMiddle.Resize(0);
     geometryFront.Resize(0);
 
-    auto font = (Font*)handle;
     FontEffect* fontEffect = &FontEffects[(int)font_effects_handle];
     Color32 color(colour.red, colour.green, colour.blue, (byte)(colour.alpha / 255.0f * opacity * 255));
+    if (UseSdf)
+    {
+        const int width = GenerateStringSdf((SdfFontFace*)handle, fontEffect, str, position, color, letter_spacing, geometryList);
+        if (timed)
+            Stats.GenerateStringTime += Platform::GetTimeSeconds() - startTime;
+        return width;
+    }
+
+    auto font = (Font*)handle;
     FontTextureAtlas* fontAtlas = nullptr;
     byte fontAtlasIndex = 0;
     Float2 invAtlasSize = Float2::One;
@@ -520,9 +1200,9 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
     Rml::Geometry* geometry = nullptr;
     Rml::Geometry* geometryEffect = nullptr;
     float pointerX = position.x;
-    for (int32 charIndex = 0; charIndex < text.Length(); charIndex++)
+    for (Rml::StringIteratorU8 it(str); it; ++it)
     {
-        const Char c = text[charIndex];
+        const Char c = GetFontCharacter(*it);
         if (c == '\n')
             continue;
 
@@ -554,10 +1234,12 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
         }
 
         const bool isWhitespace = StringUtils::IsWhitespace(c);
-        if (!isWhitespace && previousEntry.IsValid)
-            pointerX += (float)font->GetKerning(previousEntry.Character, entry.Character);
-        Float2 characterPosition(pointerX, position.y);
-        pointerX += (float)entry.AdvanceX + letter_spacing;
+        if (!isWhitespace)
+            pointerX += GetCharacterKerning(font, previousEntry, entry);
+        float glyphOffset;
+        const float advance = GetCharacterAdvance(handle, entry, glyphOffset);
+        Float2 characterPosition(pointerX + glyphOffset, position.y);
+        pointerX += advance + letter_spacing;
         previousEntry = entry;
 
         if (isWhitespace)
@@ -572,7 +1254,7 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
         // Generate geometry for effects
         for (auto& layer : fontEffect->layers)
         {
-            PROFILE_CPU_NAMED("RmlUi.GenerateString.FontEffect");
+            RMLUI_PROFILE_CPU(PerDraw, "RmlUi.GenerateString.FontEffect");
 
             const Rml::FontEffect* fontEffectLayer = layer.effect;
             Array<Rml::Geometry>& geometryLayer = fontEffectLayer->GetLayer() == Rml::FontEffect::Layer::Back ? geometryBack : geometryFront;
@@ -585,6 +1267,8 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
             AssetReference<FontTextureAtlas> effectFontAtlas;
             if (!layer.characters.TryGet(c, effectEntry))
             {
+                RMLUI_PROFILE_CPU(PerDraw, "RmlUi.GenerateFontEffectGlyph");
+
                 // Generate new effect for this glyph
                 effectEntry = entry;
 
@@ -640,38 +1324,19 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
                         }
                     }
 
-                    // Find space for the glyph in existing atlases
                     byte effectAtlasIndex = 0;
-                    FontTextureAtlasSlot* slot = nullptr;
-                    for (byte i = 0; i < (byte)EffectAtlases.Count(); i++)
+                    FontTextureAtlasSlot* slot = AddAtlasEntry(EffectAtlases, PixelFormat::B8G8R8A8_UNorm, EFFECT_FONT_ATLAS_SIZE, effectGlyphSize.x, effectGlyphSize.y, effectGlyphBytes, effectAtlasIndex);
+                    if (EffectAtlasTextures.Count() < EffectAtlases.Count())
                     {
-                        slot = EffectAtlases[i]->AddEntry(effectGlyphSize.x, effectGlyphSize.y, effectGlyphBytes);
-                        if (slot != nullptr)
-                        {
-                            effectFontAtlas = EffectAtlases[i];
-                            effectAtlasIndex = i;
-                            break;
-                        }
-                    }
-                    if (slot == nullptr)
-                    {
-                        // No space in existing atlases, create a new one
-                        effectAtlasIndex = (byte)EffectAtlases.Count();
-                        effectFontAtlas = Content::CreateVirtualAsset<FontTextureAtlas>();
-                        effectFontAtlas->Setup(PixelFormat::B8G8R8A8_UNorm, FontTextureAtlas::PaddingStyle::PadWithZero);
-                        effectFontAtlas->Init(EFFECT_FONT_ATLAS_SIZE, EFFECT_FONT_ATLAS_SIZE);
-                        EffectAtlases.Add(effectFontAtlas);
-
                         // Texture data already exists, the callback only assigns the correct handle pointing to this atlas
                         auto atlasTexture = New<Rml::Texture>();
                         EffectAtlasTextures.Add(atlasTexture);
-                        atlasTexture->Set(GetEffectAtlasTextureNameHandle(effectAtlasIndex), FontAtlasTextureCallback);
-
-                        slot = effectFontAtlas->AddEntry(effectGlyphSize.x, effectGlyphSize.y, effectGlyphBytes);
+                        atlasTexture->Set(GetEffectAtlasTextureNameHandle(EffectAtlasTextures.Count() - 1), FontAtlasTextureCallback);
                     }
 
                     if (slot)
                     {
+                        effectFontAtlas = EffectAtlases[effectAtlasIndex];
                         const uint32 padding = effectFontAtlas->GetPaddingAmount();
                         effectEntry.TextureIndex = effectAtlasIndex;
                         effectEntry.UV.X = static_cast<float>(slot->X + padding);
@@ -699,25 +1364,10 @@ int FlaxFontEngineInterface::GenerateString(Rml::FontFaceHandle handle, Rml::Fon
         }
     }
 
-    // Cull empty geometry collections from the list
-    for (int i = 0; i < geometryList.size(); i++)
-    {
-        if (!geometryList[i].GetVertices().empty())
-            continue;
-
-        geometryList.erase(geometryList.begin() + i);
-        i--;
-    }
-
-    // Insert the generated geometry to the list layer by layer
-    geometryList.reserve(geometryList.size() + geometryBack.Count() + geometryMiddle.Count() + geometryFront.Count());
-    for (Rml::Geometry& geometry : geometryBack)
-        geometryList.push_back(MoveTemp(geometry));
-    for (Rml::Geometry& geometry : geometryMiddle)
-        geometryList.push_back(MoveTemp(geometry));
-    for (Rml::Geometry& geometry : geometryFront)
-        geometryList.push_back(MoveTemp(geometry));
+    InsertGeometryLayers(geometryList, geometryBack, geometryMiddle, geometryFront);
 
+    if (timed)
+        Stats.GenerateStringTime += Platform::GetTimeSeconds() - startTime;
     return (int)pointerX;
 }
 
@@ -728,9 +1378,193 @@ int FlaxFontEngineInterface::GetVersion(Rml::FontFaceHandle handle)
     return 0;
 }
 
-void FlaxFontEngineInterface::FlushFontAtlases()
+// Bitmap glyphs can only be rasterized by the font, rasterize them now instead of on first use
+void RasterizeBitmapGlyphs(FontAsset* fontAsset, const Array<int32>& sizes, const StringView& characters)
+{
+    for (const int32 size : sizes)
+    {
+        Font* font = fontAsset->CreateFont((float)size * DPI_ADJUSTMENT);
+        if (font == nullptr)
+            continue;
+
+        FontCharacterEntry entry;
+        for (int32 i = 0; i < characters.Length(); i++)
+            font->GetCharacter(characters[i], entry);
+    }
+}
+
+bool FlaxFontEngineInterface::LoadBakedFontAtlas(RmlUiFontAtlasAsset* fontAtlasAsset)
+{
+    if (fontAtlasAsset == nullptr || fontAtlasAsset->WaitForLoaded())
+        return false;
+
+    PROFILE_CPU_NAMED("RmlUi.LoadBakedFontAtlas");
+
+    for (const RmlUiBakedFont& bakedFont : fontAtlasAsset->GetFonts())
+    {
+        AssetReference<FontAsset> fontAsset = Content::Load<FontAsset>(bakedFont.Font);
+        if (fontAsset == nullptr)
+            continue;
+
+        if (UseSdf && bakedFont.SdfBaseSize == SDF_BASE_SIZE && bakedFont.SdfSpread == SDF_SPREAD)
+        {
+            // Fill the distance field atlases directly from the baked data
+            SdfFont* sdfFont = GetSdfFont(fontAsset);
+            if (sdfFont == nullptr)
+                continue;
+
+            static Array<byte> sdfGlyphBytes;
+            for (const RmlUiBakedGlyph& bakedGlyph : bakedFont.Glyphs)
+            {
+                if (sdfFont->glyphs.ContainsKey(bakedGlyph.Character))
+                    continue;
+
+                FontCharacterEntry entry;
+                entry.Character = bakedGlyph.Character;
+                entry.IsValid = true;
+                entry.TextureIndex = 0;
+                entry.AdvanceX = bakedGlyph.AdvanceX;
+                entry.OffsetX = bakedGlyph.OffsetX;
+                entry.OffsetY = bakedGlyph.OffsetY;
+                entry.Height = bakedGlyph.Height;
+                entry.BearingY = bakedGlyph.BearingY;
+                entry.Slot = nullptr;
+
+                const int32 dataSize = bakedGlyph.BitmapWidth * bakedGlyph.BitmapHeight;
+                sdfGlyphBytes.Set(bakedFont.GlyphData.Get() + bakedGlyph.DataOffset, dataSize);
+                SdfGlyph glyph;
+                AddSdfGlyph(sdfFont, entry, sdfGlyphBytes, bakedGlyph.BitmapWidth, bakedGlyph.BitmapHeight, glyph);
+            }
+        }
+        else if (!UseSdf)
+            RasterizeBitmapGlyphs(fontAsset, bakedFont.Sizes, bakedFont.Charset);
+    }
+
+    FontManager::Flush();
+    FlushFontAtlases();
+    return true;
+}
+
+void FlaxFontEngineInterface::PrewarmGlyphs(FontAsset* fontAsset, const Array<int32>& sizes, const StringView& characters)
+{
+    if (fontAsset == nullptr || !fontAsset->IsLoaded())
+        return;
+
+    PROFILE_CPU_NAMED("RmlUi.PrewarmGlyphs");
+
+    if (UseSdf)
+    {
+        // Distance field glyphs are shared by all font sizes
+        SdfFont* sdfFont = GetSdfFont(fontAsset);
+        if (sdfFont == nullptr)
+            return;
+
+        FontCharacterEntry entry, sdfEntry;
+        for (int32 i = 0; i < characters.Length(); i++)
+            GetSdfCharacter(sdfFont, characters[i], entry, sdfEntry);
+    }
+    else
+        RasterizeBitmapGlyphs(fontAsset, sizes, characters);
+
+    FontManager::Flush();
+    FlushFontAtlases();
+}
+
+const FlaxFontEngineStats& FlaxFontEngineInterface::GetStats() const
+{
+    return Stats;
+}
+
+void FlaxFontEngineInterface::ResetStats()
+{
+    Stats = FlaxFontEngineStats();
+}
+
+void FlaxFontEngineInterface::TrimCaches()
+{
+    // Staging textures are created again by the next atlas update which needs them
+    for (const auto& e : AtlasStagingTextures)
+        SAFE_DELETE_GPU_RESOURCE(e.Value);
+    AtlasStagingTextures.Clear();
+}
+
+void AddAtlasMemory(RmlUiMemoryUsage& usage, FontTextureAtlas* atlas)
+{
+    // The atlas keeps a copy of the whole page on CPU for the glyphs added later
+    usage.Count++;
+    GPUTexture* texture = atlas != nullptr ? atlas->GetTexture() : nullptr;
+    if (texture == nullptr || !texture->IsAllocated())
+        return;
+    usage.GPUMemory += texture->GetMemoryUsage();
+    usage.CPUMemory += (uint64)texture->Width() * texture->Height() * PixelFormatExtensions::SizeInBytes(texture->Format());
+}
+
+void FlaxFontEngineInterface::GetMemoryReport(RmlUiMemoryReport& report) const
 {
-    // Flush generated effect glyphs to GPU
     for (const auto& atlas : EffectAtlases)
-        atlas->Flush();
+        AddAtlasMemory(report.EffectAtlases, atlas.Get());
+    for (const auto& atlas : SdfAtlases)
+        AddAtlasMemory(report.FontAtlases, atlas.Get());
+
+    // Only the engine atlases requested by RmlUi are counted
+    for (int32 i = 0; i < AtlasTextureNames.Count(); i++)
+        AddAtlasMemory(report.FontAtlases, FontManager::GetAtlas(i));
+
+    for (const auto& e : AtlasStagingTextures)
+        report.FontAtlases.GPUMemory += e.Value->GetMemoryUsage();
+}
+
+#if USE_EDITOR
+void FlaxFontEngineInterface::BakeSdfGlyphs(FontAsset* fontAsset, const StringView& charset, RmlUiBakedFont& bakedFont)
+{
+    Font* font = fontAsset->CreateFont((float)SDF_BASE_SIZE * DPI_ADJUSTMENT);
+    if (font == nullptr)
+        return;
+
+    bakedFont.SdfBaseSize = SDF_BASE_SIZE;
+    bakedFont.SdfSpread = SDF_SPREAD;
+    bakedFont.Glyphs.EnsureCapacity(charset.Length());
+
+    Array<byte> sdfGlyphBytes;
+    for (int32 i = 0; i < charset.Length(); i++)
+    {
+        FontCharacterEntry entry;
+        int32 sdfGlyphWidth = 0, sdfGlyphHeight = 0;
+        if (!RasterizeSdfCharacter(font, charset[i], entry, sdfGlyphBytes, sdfGlyphWidth, sdfGlyphHeight))
+            sdfGlyphWidth = sdfGlyphHeight = 0;
+        if (!entry.IsValid)
+            continue;
+
+        RmlUiBakedGlyph& bakedGlyph = bakedFont.Glyphs.AddOne();
+        bakedGlyph.Character = charset[i];
+        bakedGlyph.AdvanceX = entry.AdvanceX;
+        bakedGlyph.OffsetX = entry.OffsetX;
+        bakedGlyph.OffsetY = entry.OffsetY;
+        bakedGlyph.Height = entry.Height;
+        bakedGlyph.BearingY = entry.BearingY;
+        bakedGlyph.BitmapWidth = (uint16)sdfGlyphWidth;
+        bakedGlyph.BitmapHeight = (uint16)sdfGlyphHeight;
+        bakedGlyph.DataOffset = bakedFont.GlyphData.Count();
+        bakedFont.GlyphData.Add(sdfGlyphBytes.Get(), sdfGlyphWidth * sdfGlyphHeight);
+    }
+}
+#endif
+
+void FlaxFontEngineInterface::FlushFontAtlases(GPUContext* context)
+{
+    if (AtlasDirtyRects.IsEmpty())
+        return;
+
+    RMLUI_PROFILE_CPU(PerFrame, "RmlUi.FlushFontAtlases");
+
+    // Flush generated effect and distance field glyphs to GPU, only the modified region of each page is uploaded
+    for (const auto& e : AtlasDirtyRects)
+    {
+        FontTextureAtlas* atlas = e.Key;
+        atlas->EnsureTextureCreated();
+        if (context != nullptr)
+            UploadAtlasRegion(context, atlas, e.Value);
+    }
+    if (context != nullptr)
+        AtlasDirtyRects.Clear();
 }
\ No newline at end of file
@@ -1,6 +1,14 @@
 ﻿#pragma once
 
+#include "RmlUiMemory.h"
+
 #include <ThirdParty/RmlUi/Core/FontEngineInterface.h>
+#include <Engine/Core/Collections/Array.h>
+
+class FontAsset;
+class GPUContext;
+class RmlUiFontAtlasAsset;
+struct RmlUiBakedFont;
 
 #if !USE_RMLUI_6_0
 namespace Rml
@@ -18,6 +26,16 @@ namespace Rml
 }
 #endif
 
+/// <summary>
+/// Counters of the text generated by FlaxFontEngineInterface since the last call to ResetStats.
+/// </summary>
+struct FlaxFontEngineStats
+{
+    int32 GeneratedStrings;
+    int32 RasterizedGlyphs;
+    double GenerateStringTime;
+};
+
 /// <summary>
 /// The FontEngineInterface implementation for Flax Engine.
 /// </summary>
@@ -48,5 +66,15 @@ public:
     int GetVersion(Rml::FontFaceHandle handle) override;
 
 public:
-    void FlushFontAtlases();
+    void FlushFontAtlases(GPUContext* context = nullptr);
+    bool IsUsingSignedDistanceField() const;
+    bool LoadBakedFontAtlas(RmlUiFontAtlasAsset* fontAtlasAsset);
+    void PrewarmGlyphs(FontAsset* fontAsset, const Array<int32>& sizes, const StringView& characters);
+    const FlaxFontEngineStats& GetStats() const;
+    void ResetStats();
+    void GetMemoryReport(RmlUiMemoryReport& report) const;
+    void TrimCaches();
+#if USE_EDITOR
+    static void BakeSdfGlyphs(FontAsset* fontAsset, const StringView& charset, RmlUiBakedFont& bakedFont);
+#endif
 };
\ No newline at end of file
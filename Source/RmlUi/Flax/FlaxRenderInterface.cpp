@@ -7,6 +7,8 @@
 
 #include "FlaxFontEngineInterface.h"
 #include "FlaxRenderInterface.h"
+#include "RmlUiProfiler.h"
+#include "RmlUiRenderCapture.h"
 #include "StaticIndexBuffer.h"
 #include "StaticVertexBuffer.h"
 
@@ -22,10 +24,15 @@
 #include <Engine/Core/Collections/Dictionary.h>
 #include <Engine/Core/Collections/HashSet.h>
 #include <Engine/Core/Log.h>
+#include <Engine/Core/Math/Color32.h>
+#include <Engine/Core/Math/Half.h>
 #include <Engine/Core/Math/Matrix.h>
+#include <Engine/Graphics/DynamicBuffer.h>
+#include <Engine/Graphics/GPUBuffer.h>
 #include <Engine/Graphics/GPUContext.h>
 #include <Engine/Graphics/GPUDevice.h>
 #include <Engine/Graphics/GPUPipelineState.h>
+#include <Engine/Graphics/GPUTimerQuery.h>
 #include <Engine/Graphics/Async/GPUTask.h>
 #include <Engine/Graphics/Models/Types.h>
 #include <Engine/Graphics/RenderTask.h>
@@ -33,149 +40,1535 @@
 #include <Engine/Graphics/Textures/GPUTexture.h>
 #include <Engine/Profiler/Profiler.h>
 #include <Engine/Render2D/FontManager.h>
-#include <Engine/Render2D/RotatedRectangle.h>
+
+// Maximum number of glyphs in text geometry which is patched in place instead of being compiled again
+#define PATCH_GLYPHS_MAX 32
+
+// Geometry with more vertices is drawn from its own buffers instead of being copied to the frame batch
+#define BATCH_MAX_VERTICES 1024
+
+// Maximum number of textures bound to a single batched draw
+#define MAX_TEXTURE_SLOTS 8
+
+// Maximum number of recorded draws searched backwards for a draw to group with when reordering
+#define REORDER_WINDOW 64
+
+// Clip parallelogram covering everything, used by geometry clipped only by the hardware scissor
+#define NO_CLIP_EXTENT 1000000.0f
+
+// Number of timer queries per context, results become available a few frames after the draws were submitted
+#define TIMER_QUERY_SLOTS 4
+
+// Number of staging data arrays kept for compiling geometry, and the largest kept array (in bytes)
+#define STAGING_POOL_SIZE 16
+#define STAGING_POOL_MAX_CAPACITY (256 * 1024)
+
+// Number of frames between trimming the geometry cache
+#define TRIM_INTERVAL 30
+
+// GPU buffers of reused geometry slots larger than this (in bytes) and this many times larger than the new data are created again
+#define SHRINK_MIN_SIZE (64 * 1024)
+#define SHRINK_RATIO 4
 
 struct BasicVertex
 {
-    Float2 Position;
-    Half2 TexCoord;
-    Color Color;
-    Float2 ClipOrigin;
-    RotatedRectangle ClipMask;
-};
+    Float2 Position;
+    Half2 TexCoord;
+    Color Color;
+    Float2 ClipOrigin;
+    Float4 ClipExtents;
+    Half4 Params;
+};
+
+// Text glyph quad, expanded to four vertices in the glyph vertex shader
+struct GlyphInstance
+{
+    Float4 Rect;
+    Half4 UVRect;
+    Color32 Color;
+};
+
+// Content of compiled geometry, identical geometry compiled again shares the existing buffers
+struct GeometryKey
+{
+    uint64 hash;
+    int32 vertexCount;
+    int32 indexCount;
+    Rml::TextureHandle texture;
+
+    bool operator==(const GeometryKey& other) const
+    {
+        return hash == other.hash && vertexCount == other.vertexCount && indexCount == other.indexCount && texture == other.texture;
+    }
+};
+
+inline uint32 GetHash(const GeometryKey& key)
+{
+    return (uint32)(key.hash ^ (key.hash >> 32));
+}
+
+// Released text geometry which can be patched by text with the same number of glyphs drawn with the same texture
+struct GlyphPatchKey
+{
+    GPUTexture* texture;
+    int32 glyphCount;
+    bool isSdf;
+    Float2 sdfParams;
+
+    bool operator==(const GlyphPatchKey& other) const
+    {
+        return texture == other.texture && glyphCount == other.glyphCount && isSdf == other.isSdf && sdfParams == other.sdfParams;
+    }
+};
+
+inline uint32 GetHash(const GlyphPatchKey& key)
+{
+    uint32 hash = GetHash(key.texture);
+    CombineHash(hash, (uint32)key.glyphCount);
+    CombineHash(hash, GetHash(key.sdfParams.X));
+    CombineHash(hash, GetHash(key.sdfParams.Y));
+    return hash;
+}
+
+namespace
+{
+    Array<Array<byte>> StagingPool;
+}
+
+// Takes the smallest pooled array which fits the data, so compiling geometry doesn't allocate the staging data again
+void AcquireStagingData(Array<byte>& data, int32 capacity)
+{
+    if (data.Capacity() >= capacity)
+        return;
+
+    int32 best = -1;
+    for (int32 i = 0; i < StagingPool.Count(); i++)
+    {
+        if (StagingPool[i].Capacity() >= capacity && (best == -1 || StagingPool[i].Capacity() < StagingPool[best].Capacity()))
+            best = i;
+    }
+    if (best != -1)
+    {
+        data.Swap(StagingPool[best]);
+        StagingPool.RemoveAt(best);
+    }
+    data.EnsureCapacity(capacity);
+}
+
+// Returns the data uploaded to GPU to the pool, the geometry keeps only its GPU buffers
+void ReleaseStagingData(Array<byte>& data)
+{
+    data.Clear();
+    if (data.Capacity() == 0)
+        return;
+    if (StagingPool.Count() < STAGING_POOL_SIZE && data.Capacity() <= STAGING_POOL_MAX_CAPACITY)
+        StagingPool.AddOne().Swap(data);
+    else
+        data.SetCapacity(0, false);
+}
+
+struct CompiledGeometry
+{
+public:
+    CompiledGeometry()
+        : reserved(true)
+        , vertexBuffer(512, sizeof(BasicVertex), TEXT("RmlUi.VB"))
+        , indexBuffer(64, sizeof(uint32), TEXT("RmlUi.IB"))
+        , glyphBuffer(0, sizeof(GlyphInstance), TEXT("RmlUi.Glyphs"))
+        , texture(nullptr)
+        , isFont(false)
+        , isGlyphs(false)
+        , isSdf(false)
+        , sdfParams(Float2::Zero)
+        , bounds(Rectangle::Empty)
+        , dirty(true)
+        , glyphDirtyStart(0)
+        , glyphDirtyEnd(0)
+        , patchable(false)
+        , refCount(0)
+        , hashed(false)
+        , vertexCount(0)
+        , indexCount(0)
+        , glyphCount(0)
+        , lastUsedFrame(0)
+        , released(false)
+        , prevReleased(0)
+        , nextReleased(0)
+        , context(nullptr)
+    {
+    }
+
+    ~CompiledGeometry()
+    {
+        Dispose(false);
+    }
+
+    void Dispose(bool preserveBuffers = true)
+    {
+        reserved = false;
+        texture = nullptr;
+        if (preserveBuffers)
+        {
+            // The GPU buffers are reused by the next geometry compiled into the slot
+            ReleaseStagingData(vertexBuffer.Data);
+            ReleaseStagingData(indexBuffer.Data);
+            ReleaseStagingData(glyphBuffer.Data);
+        }
+        else
+        {
+            vertexBuffer.Dispose();
+            indexBuffer.Dispose();
+            glyphBuffer.Dispose();
+            ReleaseStagingData(vertexBuffer.Data);
+            ReleaseStagingData(indexBuffer.Data);
+            ReleaseStagingData(glyphBuffer.Data);
+        }
+        isFont = false;
+        isGlyphs = false;
+        isSdf = false;
+        dirty = true;
+        glyphDirtyStart = glyphDirtyEnd = 0;
+        vertexCount = indexCount = glyphCount = 0;
+        context = nullptr;
+    }
+
+    void Release()
+    {
+        // Released geometry stays around until the slot is reused, so identical geometry compiled again can take it back
+        // and the same text compiled again with a few changed glyphs can be patched in place
+        reserved = false;
+    }
+
+    GlyphPatchKey GetPatchKey() const
+    {
+        return { texture, glyphCount, isSdf, isSdf ? sdfParams : Float2::Zero };
+    }
+
+    // Glyphs which may be patched later keep their data on CPU, the rest of the data is released after the upload to GPU
+    bool KeepsStagingData() const
+    {
+        return isGlyphs ? glyphCount <= PATCH_GLYPHS_MAX : vertexCount <= BATCH_MAX_VERTICES;
+    }
+
+    bool reserved;
+    StaticVertexBuffer vertexBuffer;
+    StaticIndexBuffer indexBuffer;
+    StaticVertexBuffer glyphBuffer;
+    GPUTexture* texture;
+    bool isFont;
+    bool isGlyphs;
+    bool isSdf;
+    Float2 sdfParams;
+    Rectangle bounds;
+    bool dirty;
+    int32 glyphDirtyStart;
+    int32 glyphDirtyEnd;
+    bool patchable;
+    int32 refCount;
+    bool hashed;
+    GeometryKey key;
+    int32 vertexCount;
+    int32 indexCount;
+    int32 glyphCount;
+    int32 lastUsedFrame;
+
+    // Released geometry is linked in the list ordered by the last used frame, slot 0 ends the list
+    bool released;
+    int32 prevReleased;
+    int32 nextReleased;
+
+    // The context rendered when the geometry was compiled, only used for the memory report
+    Rml::Context* context;
+};
+
+PACK_STRUCT(struct CustomData
+{
+    Matrix ViewProjection;
+    Matrix Model;
+    Float2 Offset;
+    Float2 SdfParams;
+});
+
+// Shading mode stored in each vertex, must match DRAW_MODE_ defines in Basic.shader
+enum class DrawMode : byte
+{
+    Color,
+    Image,
+    Font,
+    Sdf,
+};
+
+enum class DrawPipeline : byte
+{
+    Basic,
+    BasicNoClip,
+    Glyph,
+    GlyphSdf,
+    MAX
+};
+
+struct RecordedDraw
+{
+    DrawPipeline pipeline;
+    GPUTexture* texture;
+    Float2 sdfParams;
+    int32 transformIndex;
+    int32 context;
+
+    // Direct draws use the buffers of the compiled geometry, batched draws use the index range of the frame batch
+    CompiledGeometry* geometry;
+    Float2 translation;
+    Rectangle scissor;
+
+    // Conservative screen-space area affected by the draw
+    Rectangle bounds;
+
+    // Batched geometry which is not fully inside of its clip rectangle needs per-pixel clipping
+    bool clipped;
+    int32 vertexStart;
+    int32 vertexCount;
+    int32 indexStart;
+    int32 indexCount;
+};
+
+// GPU timer queries measuring the draw calls of a single context, the results are read back a few frames later so the timers are kept by the context
+struct ContextTimer
+{
+    ContextTimer()
+        : active(0)
+        , frame(0)
+        , gpuTime(0.0f)
+    {
+        for (int32 slot = 0; slot < TIMER_QUERY_SLOTS; slot++)
+        {
+            queries[slot] = nullptr;
+            pending[slot] = false;
+        }
+    }
+
+    bool IsPending() const
+    {
+        for (int32 slot = 0; slot < TIMER_QUERY_SLOTS; slot++)
+        {
+            if (pending[slot])
+                return true;
+        }
+        return false;
+    }
+
+    void Dispose()
+    {
+        for (GPUTimerQuery*& query : queries)
+            SAFE_DELETE_GPU_RESOURCE(query);
+    }
+
+    GPUTimerQuery* queries[TIMER_QUERY_SLOTS];
+    bool pending[TIMER_QUERY_SLOTS];
+    int32 active;
+    int32 frame;
+    float gpuTime;
+};
+
+// Range of recorded draws submitted with a single draw call
+struct DrawSubmit
+{
+    DrawPipeline pipeline;
+    int32 first;
+    int32 indexCount;
+    int32 textureCount;
+    GPUTexture* textures[MAX_TEXTURE_SLOTS];
+};
+
+namespace
+{
+    RenderContext* CurrentRenderContext = nullptr;
+    GPUContext* CurrentGPUContext = nullptr;
+    Viewport CurrentViewport;
+    Rectangle CurrentScissor;
+    Matrix CurrentTransform;
+    Matrix ViewProjection;
+    bool UseScissor = false;
+    AssetReference<Shader> BasicShader;
+    GPUPipelineState* Pipelines[(int32)DrawPipeline::MAX] = {};
+    GPUBuffer* GlyphQuadVertexBuffer = nullptr;
+    GPUBuffer* GlyphQuadIndexBuffer = nullptr;
+    Array<CompiledGeometry*> GeometryCache(2);
+    Array<int32> FreeGeometrySlots;
+    int32 ReleasedGeometryFirst = 0;
+    int32 ReleasedGeometryLast = 0;
+    Array<GlyphInstance> GlyphScratch;
+    Dictionary<GeometryKey, int32> GeometryHashes(256);
+    Dictionary<GlyphPatchKey, Array<int32>> PatchableGlyphs(64);
+    Array<RecordedDraw> RecordedDraws(256);
+    Array<Matrix> RecordedTransforms(8);
+    DynamicVertexBuffer* BatchVertexBuffer = nullptr;
+    DynamicIndexBuffer* BatchIndexBuffer = nullptr;
+    Array<DrawSubmit> DrawSubmits(64);
+    int32 TextureSlotCount = 1;
+    bool ReorderDraws = false;
+    Array<byte> ReorderScratch;
+    FlaxRenderStats Stats = {};
+    int32 CurrentContextIndex = 0;
+    Rml::Context* CurrentContext = nullptr;
+    int32 TrimUnusedFrames = 0;
+    uint64 TrimBudget = 0;
+    Array<FlaxRenderStats> ContextStats(8);
+    Dictionary<Rml::Context*, ContextTimer> ContextTimers(8);
+    Array<Rml::Context*> FrameContexts(8);
+    int32 TimerFrame = 0;
+    bool Headless = false;
+    Array<FlaxDrawCommand> HeadlessCommands(256);
+    Dictionary<GPUTexture*, AssetReference<Texture>> LoadedTextureAssets(32);
+    Array<GPUTexture*> LoadedTextures(32);
+    Array<GPUTexture*> AllocatedTextures(32);
+    HashSet<GPUTexture*> FontTextures(32);
+    Dictionary<Rml::TextureHandle, Float2> SdfTextureParams(8);
+#if !USE_RMLUI_6_0
+    Dictionary<byte*, Rml::TextureHandle> AtlasGenerateTextureHandles;
+#endif
+}
+
+#define HASH64_PRIME1 0x9E3779B185EBCA87ull
+#define HASH64_PRIME2 0xC2B2AE3D27D4EB4Full
+#define HASH64_PRIME3 0x165667B19E3779F9ull
+#define HASH64_PRIME4 0x85EBCA77C2B2AE63ull
+#define HASH64_PRIME5 0x27D4EB2F165667C5ull
+
+inline uint64 RotateLeft64(uint64 value, int32 bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64 Hash64Round(uint64 accumulator, uint64 input)
+{
+    accumulator += input * HASH64_PRIME2;
+    return RotateLeft64(accumulator, 31) * HASH64_PRIME1;
+}
+
+inline uint64 Hash64Merge(uint64 accumulator, uint64 value)
+{
+    accumulator ^= Hash64Round(0, value);
+    return accumulator * HASH64_PRIME1 + HASH64_PRIME4;
+}
+
+// 64-bit content hash (xxHash64), the geometry is shared by the hash so collisions of a 32-bit checksum are not acceptable
+uint64 MemHash64(const void* data, int32 length, uint64 seed)
+{
+    const byte* input = (const byte*)data;
+    const byte* end = input + length;
+    uint64 hash;
+    uint64 lane;
+    uint32 lane32;
+    if (length >= 32)
+    {
+        uint64 v1 = seed + HASH64_PRIME1 + HASH64_PRIME2;
+        uint64 v2 = seed + HASH64_PRIME2;
+        uint64 v3 = seed;
+        uint64 v4 = seed - HASH64_PRIME1;
+        for (; input + 32 <= end; input += 32)
+        {
+            Platform::MemoryCopy(&lane, input, 8);
+            v1 = Hash64Round(v1, lane);
+            Platform::MemoryCopy(&lane, input + 8, 8);
+            v2 = Hash64Round(v2, lane);
+            Platform::MemoryCopy(&lane, input + 16, 8);
+            v3 = Hash64Round(v3, lane);
+            Platform::MemoryCopy(&lane, input + 24, 8);
+            v4 = Hash64Round(v4, lane);
+        }
+        hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) + RotateLeft64(v4, 18);
+        hash = Hash64Merge(hash, v1);
+        hash = Hash64Merge(hash, v2);
+        hash = Hash64Merge(hash, v3);
+        hash = Hash64Merge(hash, v4);
+    }
+    else
+        hash = seed + HASH64_PRIME5;
+    hash += (uint64)length;
+
+    for (; input + 8 <= end; input += 8)
+    {
+        Platform::MemoryCopy(&lane, input, 8);
+        hash ^= Hash64Round(0, lane);
+        hash = RotateLeft64(hash, 27) * HASH64_PRIME1 + HASH64_PRIME4;
+    }
+    if (input + 4 <= end)
+    {
+        Platform::MemoryCopy(&lane32, input, 4);
+        hash ^= (uint64)lane32 * HASH64_PRIME1;
+        hash = RotateLeft64(hash, 23) * HASH64_PRIME2 + HASH64_PRIME3;
+        input += 4;
+    }
+    for (; input < end; input++)
+    {
+        hash ^= (uint64)*input * HASH64_PRIME5;
+        hash = RotateLeft64(hash, 11) * HASH64_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH64_PRIME2;
+    hash ^= hash >> 29;
+    hash *= HASH64_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+GeometryKey GetGeometryKey(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture_handle)
+{
+    GeometryKey key;
+    key.hash = MemHash64(vertices, num_vertices * sizeof(Rml::Vertex), (uint64)texture_handle);
+    key.hash = MemHash64(indices, num_indices * sizeof(int), key.hash);
+    key.vertexCount = num_vertices;
+    key.indexCount = num_indices;
+    key.texture = texture_handle;
+    return key;
+}
+
+void UnregisterGeometryKey(int32 index)
+{
+    CompiledGeometry* geometry = GeometryCache[index];
+    if (!geometry->hashed)
+        return;
+
+    int32 registeredIndex;
+    if (GeometryHashes.TryGet(geometry->key, registeredIndex) && registeredIndex == index)
+        GeometryHashes.Remove(geometry->key);
+    geometry->hashed = false;
+}
+
+void RegisterGeometryKey(int32 index, const GeometryKey& key)
+{
+    UnregisterGeometryKey(index);
+    GeometryHashes[key] = index;
+    GeometryCache[index]->key = key;
+    GeometryCache[index]->hashed = true;
+}
+
+// Released text geometry is listed by its patch key, the most recently released geometry last
+void RegisterPatchableGlyphs(int32 index)
+{
+    CompiledGeometry* geometry = GeometryCache[index];
+    if (!geometry->isGlyphs || geometry->glyphCount > PATCH_GLYPHS_MAX)
+        return;
+    PatchableGlyphs[geometry->GetPatchKey()].Add(index);
+    geometry->patchable = true;
+}
+
+void UnregisterPatchableGlyphs(int32 index)
+{
+    CompiledGeometry* geometry = GeometryCache[index];
+    if (!geometry->patchable)
+        return;
+
+    Array<int32>* indices = PatchableGlyphs.TryGet(geometry->GetPatchKey());
+    if (indices != nullptr)
+    {
+        const int32 position = indices->Find(index);
+        if (position != -1)
+            indices->RemoveAtKeepOrder(position);
+    }
+    geometry->patchable = false;
+}
+
+// Inserts the released geometry into the list from the least recently used, geometry is usually released in the frame it was last used
+void LinkReleasedGeometry(int32 index)
+{
+    CompiledGeometry* geometry = GeometryCache[index];
+    int32 prev = ReleasedGeometryLast;
+    while (prev != 0 && GeometryCache[prev]->lastUsedFrame > geometry->lastUsedFrame)
+        prev = GeometryCache[prev]->prevReleased;
+    const int32 next = prev != 0 ? GeometryCache[prev]->nextReleased : ReleasedGeometryFirst;
+
+    geometry->prevReleased = prev;
+    geometry->nextReleased = next;
+    geometry->released = true;
+    if (prev != 0)
+        GeometryCache[prev]->nextReleased = index;
+    else
+        ReleasedGeometryFirst = index;
+    if (next != 0)
+        GeometryCache[next]->prevReleased = index;
+    else
+        ReleasedGeometryLast = index;
+}
+
+void UnlinkReleasedGeometry(int32 index)
+{
+    CompiledGeometry* geometry = GeometryCache[index];
+    if (!geometry->released)
+        return;
+
+    if (geometry->prevReleased != 0)
+        GeometryCache[geometry->prevReleased]->nextReleased = geometry->nextReleased;
+    else
+        ReleasedGeometryFirst = geometry->nextReleased;
+    if (geometry->nextReleased != 0)
+        GeometryCache[geometry->nextReleased]->prevReleased = geometry->prevReleased;
+    else
+        ReleasedGeometryLast = geometry->prevReleased;
+    geometry->prevReleased = geometry->nextReleased = 0;
+    geometry->released = false;
+}
+
+CompiledGeometry* ReserveGeometry(Rml::CompiledGeometryHandle& geometryHandle)
+{
+    // Cache geometry structures in order to reduce allocations and recreating buffers. Empty slots are used first,
+    // then the least recently used released geometry is evicted, and its GPU buffers are reused.
+    int32 index;
+    if (FreeGeometrySlots.HasItems())
+    {
+        index = FreeGeometrySlots.Last();
+        FreeGeometrySlots.RemoveLast();
+    }
+    else if (ReleasedGeometryFirst != 0)
+    {
+        index = ReleasedGeometryFirst;
+        UnlinkReleasedGeometry(index);
+        UnregisterGeometryKey(index);
+        UnregisterPatchableGlyphs(index);
+        GeometryCache[index]->Dispose();
+    }
+    else
+    {
+        index = GeometryCache.Count();
+        GeometryCache.Add(New<CompiledGeometry>());
+    }
+
+    CompiledGeometry* geometry = GeometryCache[index];
+    geometry->reserved = true;
+    geometry->refCount = 1;
+    geometryHandle = Rml::CompiledGeometryHandle(index);
+    return geometry;
+}
+
+BasicVertex ConvertVertex(const Rml::Vertex& vertex, DrawMode mode, const Float2& sdfParams)
+{
+    BasicVertex result;
+    result.Position = (Float2)vertex.position;
+    result.TexCoord = Half2((Float2)vertex.tex_coord);
+    result.Color = Color(Color32(vertex.colour.red, vertex.colour.green, vertex.colour.blue, vertex.colour.alpha));
+    result.ClipOrigin = Float2(-NO_CLIP_EXTENT);
+    result.ClipExtents = Float4(2 * NO_CLIP_EXTENT, 0, 0, 2 * NO_CLIP_EXTENT);
+    result.Params = Half4((float)mode, sdfParams.X, sdfParams.Y, 0.0f);
+    return result;
+}
+
+DrawMode GetDrawMode(Rml::TextureHandle textureHandle, Float2& sdfParams)
+{
+    sdfParams = Float2::Zero;
+    GPUTexture* texture = LoadedTextures.At((int32)textureHandle);
+    if (texture == nullptr)
+        return DrawMode::Color;
+    if (SdfTextureParams.TryGet(textureHandle, sdfParams))
+        return DrawMode::Sdf;
+    if (FontTextures.Contains(texture))
+        return DrawMode::Font;
+    return DrawMode::Image;
+}
+
+Rectangle GetClipRectangle()
+{
+    return UseScissor ? CurrentScissor : Rectangle(CurrentViewport.Location, CurrentViewport.Size);
+}
+
+Rectangle GetGeometryBounds(const Rml::Vertex* vertices, int num_vertices)
+{
+    if (num_vertices == 0)
+        return Rectangle::Empty;
+
+    Float2 min = Float2::Maximum, max = Float2::Minimum;
+    for (int i = 0; i < num_vertices; i++)
+    {
+        const Float2 position = (Float2)vertices[i].position;
+        min = Float2::Min(min, position);
+        max = Float2::Max(max, position);
+    }
+    return Rectangle(min, max - min);
+}
+
+// Returns true if the translated geometry bounds are fully outside of the clip rectangle and the viewport
+bool IsGeometryCulled(const Rectangle& bounds, const Float2& translation)
+{
+    Rectangle screenBounds(bounds.Location + translation, bounds.Size);
+    if (!CurrentTransform.IsIdentity())
+    {
+        // Geometry behind the projection plane of perspective transforms is never culled
+        const Float2 corners[4] = { screenBounds.GetUpperLeft(), screenBounds.GetUpperRight(), screenBounds.GetBottomRight(), screenBounds.GetBottomLeft() };
+        Float2 min = Float2::Maximum, max = Float2::Minimum;
+        for (const Float2& corner : corners)
+        {
+            Float4 position;
+            Float4::Transform(Float4(corner, 0, 1), CurrentTransform, position);
+            if (position.W <= ZeroTolerance)
+                return false;
+            const Float2 projected(position.X / position.W, position.Y / position.W);
+            min = Float2::Min(min, projected);
+            max = Float2::Max(max, projected);
+        }
+        screenBounds = Rectangle(min, max - min);
+    }
+
+    const Rectangle clipBounds = Rectangle::Shared(GetClipRectangle(), Rectangle(CurrentViewport.Location, CurrentViewport.Size));
+    return !clipBounds.Intersects(screenBounds);
+}
+
+DrawPipeline GetDrawPipeline(const CompiledGeometry* compiledGeometry)
+{
+    if (compiledGeometry->isGlyphs)
+        return compiledGeometry->isSdf ? DrawPipeline::GlyphSdf : DrawPipeline::Glyph;
+
+    // Geometry drawn from its own buffers is clipped by the scissor rectangle
+    return DrawPipeline::BasicNoClip;
+}
+
+bool InitPipelines()
+{
+    if (Pipelines[(int32)DrawPipeline::MAX - 1] != nullptr)
+        return false;
+
+    // The UI is not drawn until the shader is loaded, instead of stalling the frame on it
+    if (!BasicShader->IsLoaded())
+        return true;
+
+    GPUPipelineState::Description desc = GPUPipelineState::Description::DefaultFullscreenTriangle;
+    desc.DepthEnable = desc.DepthWriteEnable = false;
+    desc.DepthClipEnable = false;
+    desc.CullMode = CullMode::TwoSided;
+    desc.BlendMode = BlendingMode::AlphaBlend;
+
+    // Indexing the bound textures in the pixel shader requires shader model 4
+    if (TextureSlotCount > 1 && GPUDevice::Instance->GetFeatureLevel() < FeatureLevel::SM4)
+    {
+        LOG(Info, "RmlUi: Multiple texture slots are not supported on this device, using a single texture per batch");
+        TextureSlotCount = 1;
+    }
+
+    // Shader entry points and the CLIPPING_ENABLE permutation of the basic shaders
+    const char* basicPS = TextureSlotCount > 1 ? "PS_MultiTexture" : "PS";
+    const struct
+    {
+        const char* vs;
+        const char* ps;
+        int32 permutation;
+    } shaders[(int32)DrawPipeline::MAX] =
+    {
+        { "VS", basicPS, 1 },
+        { "VS", basicPS, 0 },
+        { "VS_Glyph", "PS_Font", 0 },
+        { "VS_Glyph", "PS_FontSdf", 0 },
+    };
+    for (int32 i = 0; i < (int32)DrawPipeline::MAX; i++)
+    {
+        if (Pipelines[i] != nullptr)
+            continue;
+
+        desc.VS = BasicShader->GetShader()->GetVS(shaders[i].vs, shaders[i].permutation);
+        desc.PS = BasicShader->GetShader()->GetPS(shaders[i].ps, shaders[i].permutation);
+        Pipelines[i] = GPUDevice::Instance->CreatePipelineState();
+        if (Pipelines[i]->Init(desc))
+        {
+            LOG(Error, "RmlUi: Failed to create pipeline state for {0}", String(shaders[i].ps));
+            SAFE_DELETE_GPU_RESOURCE(Pipelines[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+RecordedDraw& RecordDraw(DrawPipeline pipeline, GPUTexture* texture, const Float2& sdfParams)
+{
+    if (RecordedTransforms.IsEmpty() || RecordedTransforms.Last() != CurrentTransform)
+        RecordedTransforms.Add(CurrentTransform);
+
+    RecordedDraw& draw = RecordedDraws.AddOne();
+    draw.pipeline = pipeline;
+    draw.texture = texture;
+    draw.sdfParams = sdfParams;
+    draw.transformIndex = RecordedTransforms.Count() - 1;
+    draw.context = CurrentContextIndex;
+    draw.geometry = nullptr;
+    draw.translation = Float2::Zero;
+    draw.scissor = GetClipRectangle();
+    draw.bounds = draw.scissor;
+    draw.clipped = false;
+    draw.vertexStart = BatchVertexBuffer->Data.Count() / sizeof(BasicVertex);
+    draw.vertexCount = 0;
+    draw.indexStart = BatchIndexBuffer->Data.Count() / sizeof(uint32);
+    draw.indexCount = 0;
+    return draw;
+}
+
+// Copies the vertices to the frame batch with the translation applied and the current clip rectangle stored per vertex
+void BatchVertices(const BasicVertex* vertices, int32 numVertices, const int* indices, int32 numIndices, const Float2& translation, RecordedDraw& draw)
+{
+    const uint32 vertexStart = BatchVertexBuffer->Data.Count() / sizeof(BasicVertex);
+    const Float4 clipExtents(draw.scissor.Size.X, 0, 0, draw.scissor.Size.Y);
+    Float2 boundsMin = Float2::Maximum, boundsMax = Float2::Minimum;
+    BatchVertexBuffer->Data.EnsureCapacity(BatchVertexBuffer->Data.Count() + numVertices * sizeof(BasicVertex));
+    for (int32 i = 0; i < numVertices; i++)
+    {
+        BasicVertex vertex = vertices[i];
+        vertex.Position += translation;
+        vertex.ClipOrigin = draw.scissor.Location;
+        vertex.ClipExtents = clipExtents;
+        boundsMin = Float2::Min(boundsMin, vertex.Position);
+        boundsMax = Float2::Max(boundsMax, vertex.Position);
+        BatchVertexBuffer->Write(vertex);
+    }
+    // Transformed geometry is bounded only by the clip rectangle
+    if (numVertices != 0 && RecordedTransforms[draw.transformIndex].IsIdentity())
+    {
+        const Float2 scissorMin = draw.scissor.GetUpperLeft(), scissorMax = draw.scissor.GetBottomRight();
+        draw.clipped = boundsMin.X < scissorMin.X || boundsMin.Y < scissorMin.Y || boundsMax.X > scissorMax.X || boundsMax.Y > scissorMax.Y;
+        draw.bounds = Rectangle::Shared(draw.bounds, Rectangle(boundsMin, boundsMax - boundsMin));
+    }
+    else
+        draw.clipped = numVertices != 0;
+    BatchIndexBuffer->Data.EnsureCapacity(BatchIndexBuffer->Data.Count() + numIndices * sizeof(uint32));
+    for (int32 i = 0; i < numIndices; i++)
+        BatchIndexBuffer->Write(vertexStart + (uint32)indices[i]);
+    draw.vertexCount = numVertices;
+    draw.indexCount = numIndices;
+}
+
+// Small text is expanded back to quads in the frame batch, so it merges into the draw calls of the surrounding batched geometry
+void BatchGlyphs(const CompiledGeometry* compiledGeometry, const Float2& translation)
+{
+    // Corners and winding match the quads written by the font engine
+    static const Float2 corners[4] = { Float2(1, 1), Float2(0, 1), Float2(0, 0), Float2(1, 0) };
+    static Array<BasicVertex> glyphVertices;
+    static Array<int> glyphIndices;
+    const int32 glyphCount = compiledGeometry->glyphCount;
+    if (glyphIndices.Count() < glyphCount * 6)
+    {
+        const int32 start = glyphIndices.Count() / 6;
+        for (int32 i = start; i < glyphCount; i++)
+        {
+            const int base = i * 4;
+            const int quadIndices[6] = { base + 0, base + 1, base + 2, base + 2, base + 3, base + 0 };
+            glyphIndices.Add(quadIndices, 6);
+        }
+    }
+
+    const DrawMode mode = compiledGeometry->isSdf ? DrawMode::Sdf : DrawMode::Font;
+    const Float2 sdfParams = compiledGeometry->isSdf ? compiledGeometry->sdfParams : Float2::Zero;
+    const Half4 params((float)mode, sdfParams.X, sdfParams.Y, 0.0f);
+    const GlyphInstance* glyphs = (const GlyphInstance*)compiledGeometry->glyphBuffer.Data.Get();
+    glyphVertices.Resize(glyphCount * 4, false);
+    for (int32 i = 0; i < glyphCount; i++)
+    {
+        const GlyphInstance& glyph = glyphs[i];
+        const Float4 uvRect = glyph.UVRect.ToFloat4();
+        const Color color(glyph.Color);
+        for (int32 corner = 0; corner < 4; corner++)
+        {
+            BasicVertex& vertex = glyphVertices[i * 4 + corner];
+            vertex.Position = Float2(glyph.Rect.X, glyph.Rect.Y) + corners[corner] * Float2(glyph.Rect.Z, glyph.Rect.W);
+            vertex.TexCoord = Half2(Math::Lerp(uvRect.X, uvRect.Z, corners[corner].X), Math::Lerp(uvRect.Y, uvRect.W, corners[corner].Y));
+            vertex.Color = color;
+            vertex.Params = params;
+        }
+    }
+
+    RecordedDraw& draw = RecordDraw(DrawPipeline::Basic, compiledGeometry->texture, Float2::Zero);
+    BatchVertices(glyphVertices.Get(), glyphCount * 4, glyphIndices.Get(), glyphCount * 6, translation, draw);
+}
+
+// Returns the slot of the texture in the submit or -1 if all slots are taken, solid color draws don't sample and fit any submit
+int32 GetTextureSlot(DrawSubmit& submit, GPUTexture* texture)
+{
+    if (texture == nullptr)
+        return 0;
+    for (int32 slot = 0; slot < submit.textureCount; slot++)
+    {
+        if (submit.textures[slot] == texture)
+            return slot;
+    }
+    if (submit.textureCount == TextureSlotCount)
+        return -1;
+    submit.textures[submit.textureCount] = texture;
+    return submit.textureCount++;
+}
+
+bool CanMergeDraws(const RecordedDraw& a, const RecordedDraw& b)
+{
+    return a.geometry == nullptr && b.geometry == nullptr && a.pipeline == b.pipeline && a.sdfParams == b.sdfParams &&
+           a.transformIndex == b.transformIndex && a.indexStart + a.indexCount == b.indexStart;
+}
+
+// Draws which are merged into a single draw call when recorded next to each other
+bool CanGroupDraws(const RecordedDraw& a, const RecordedDraw& b)
+{
+    return a.geometry == nullptr && b.geometry == nullptr && a.pipeline == b.pipeline && a.texture == b.texture &&
+           a.sdfParams == b.sdfParams && a.transformIndex == b.transformIndex;
+}
+
+// Moves each batched draw back next to the closest earlier draw it groups with, as long as it doesn't overlap any of the draws it passes
+void ReorderRecordedDraws()
+{
+    RMLUI_PROFILE_CPU(PerFrame, "RmlUi.ReorderDraws");
+
+    int32 reordered = 0;
+    for (int32 i = 1; i < RecordedDraws.Count(); i++)
+    {
+        const RecordedDraw& draw = RecordedDraws[i];
+        if (draw.geometry != nullptr || CanGroupDraws(RecordedDraws[i - 1], draw))
+            continue;
+
+        int32 target = -1;
+        for (int32 j = i - 1; j >= 0 && j >= i - REORDER_WINDOW; j--)
+        {
+            if (CanGroupDraws(RecordedDraws[j], draw))
+            {
+                target = j + 1;
+                break;
+            }
+            if (RecordedDraws[j].bounds.Intersects(draw.bounds))
+                break;
+        }
+        if (target == -1)
+            continue;
+
+        const RecordedDraw moved = draw;
+        for (int32 j = i; j > target; j--)
+            RecordedDraws[j] = RecordedDraws[j - 1];
+        RecordedDraws[target] = moved;
+        reordered++;
+    }
+    if (reordered == 0)
+        return;
+    Stats.ReorderedDraws += reordered;
+
+    // Rewrite the batched indices in the new order so the grouped draws have contiguous index ranges
+    ReorderScratch.Set(BatchIndexBuffer->Data.Get(), BatchIndexBuffer->Data.Count());
+    BatchIndexBuffer->Data.Clear();
+    for (RecordedDraw& draw : RecordedDraws)
+    {
+        if (draw.geometry != nullptr)
+            continue;
+        const int32 indexStart = BatchIndexBuffer->Data.Count() / sizeof(uint32);
+        BatchIndexBuffer->Write(ReorderScratch.Get() + draw.indexStart * sizeof(uint32), draw.indexCount * sizeof(uint32));
+        draw.indexStart = indexStart;
+    }
+}
+
+void WriteTextureSlot(const RecordedDraw& draw, int32 slot)
+{
+    if (TextureSlotCount == 1)
+        return;
+
+    const Half slotValue = Float16Compressor::Compress((float)slot);
+    BasicVertex* vertices = (BasicVertex*)BatchVertexBuffer->Data.Get() + draw.vertexStart;
+    for (int32 i = 0; i < draw.vertexCount; i++)
+        vertices[i].Params.W = slotValue;
+}
+
+// Groups the recorded draws into draw calls, batched draws are clipped per vertex so they merge regardless of their clip rectangles
+void BuildDrawSubmits()
+{
+    DrawSubmits.Clear();
+    for (int32 i = 0; i < RecordedDraws.Count(); i++)
+    {
+        DrawSubmit& submit = DrawSubmits.AddOne();
+        submit.pipeline = RecordedDraws[i].pipeline;
+        submit.first = i;
+        submit.indexCount = RecordedDraws[i].indexCount;
+        submit.textureCount = 0;
+        WriteTextureSlot(RecordedDraws[i], GetTextureSlot(submit, RecordedDraws[i].texture));
+        if (RecordedDraws[i].geometry != nullptr)
+            continue;
+
+        // Batches of geometry which stays inside of the clip rectangles use the shader permutation without clipping
+        bool clipped = RecordedDraws[i].clipped;
+        while (i + 1 < RecordedDraws.Count() && CanMergeDraws(RecordedDraws[i], RecordedDraws[i + 1]))
+        {
+            const int32 slot = GetTextureSlot(submit, RecordedDraws[i + 1].texture);
+            if (slot == -1)
+                break;
+            WriteTextureSlot(RecordedDraws[i + 1], slot);
+            submit.indexCount += RecordedDraws[++i].indexCount;
+            clipped |= RecordedDraws[i].clipped;
+        }
+        if (!clipped)
+            submit.pipeline = DrawPipeline::BasicNoClip;
+    }
+}
+
+// Describes the draw call of the submit and the state changes from the previous submit
+FlaxDrawCommand DescribeSubmit(int32 submitIndex)
+{
+    const DrawSubmit& submit = DrawSubmits[submitIndex];
+    const RecordedDraw& draw = RecordedDraws[submit.first];
+    const CompiledGeometry* compiledGeometry = draw.geometry;
+
+    FlaxDrawCommand command;
+    command.Pipeline = (int32)submit.pipeline;
+    command.InstanceCount = compiledGeometry != nullptr && compiledGeometry->isGlyphs ? compiledGeometry->glyphCount : 1;
+    command.TextureCount = submit.textureCount;
+    command.Scissor = compiledGeometry != nullptr ? draw.scissor : Rectangle(CurrentViewport.Location, CurrentViewport.Size);
+    if (compiledGeometry == nullptr)
+    {
+        const int32 drawEnd = submitIndex + 1 < DrawSubmits.Count() ? DrawSubmits[submitIndex + 1].first : RecordedDraws.Count();
+        command.VertexCount = 0;
+        for (int32 i = submit.first; i < drawEnd; i++)
+            command.VertexCount += RecordedDraws[i].vertexCount;
+        command.IndexCount = submit.indexCount;
+    }
+    else if (compiledGeometry->isGlyphs)
+    {
+        command.VertexCount = compiledGeometry->glyphCount * 4;
+        command.IndexCount = compiledGeometry->glyphCount * 6;
+    }
+    else
+    {
+        command.VertexCount = compiledGeometry->vertexCount;
+        command.IndexCount = compiledGeometry->indexCount;
+    }
+
+    command.TextureBinds = submit.textureCount;
+    command.StateChanged = true;
+    if (submitIndex != 0)
+    {
+        const DrawSubmit& previous = DrawSubmits[submitIndex - 1];
+        const RecordedDraw& previousDraw = RecordedDraws[previous.first];
+        for (int32 slot = 0; slot < submit.textureCount && slot < previous.textureCount; slot++)
+        {
+            if (submit.textures[slot] == previous.textures[slot])
+                command.TextureBinds--;
+        }
+        command.StateChanged = submit.pipeline != previous.pipeline || draw.transformIndex != previousDraw.transformIndex ||
+                               (compiledGeometry != nullptr) != (previousDraw.geometry != nullptr) || (compiledGeometry != nullptr && draw.scissor != previousDraw.scissor);
+    }
+    return command;
+}
+
+// Starts measuring the draw calls of the context, each context is measured once per frame
+bool BeginContextTimer(int32 contextIndex)
+{
+    if (!RmlUiProfileScope::IsEnabled(RmlUiInstrumentationLevel::PerCanvas))
+        return false;
+    Rml::Context* context = contextIndex < FrameContexts.Count() ? FrameContexts[contextIndex] : nullptr;
+    if (context == nullptr)
+        return false;
+    ContextTimer& timer = ContextTimers[context];
+    if (timer.frame == TimerFrame)
+        return false;
+
+    for (int32 slot = 0; slot < TIMER_QUERY_SLOTS; slot++)
+    {
+        if (timer.pending[slot])
+            continue;
+
+        if (timer.queries[slot] == nullptr)
+            timer.queries[slot] = GPUDevice::Instance->CreateTimerQuery();
+        timer.queries[slot]->Begin();
+        timer.active = slot;
+        timer.frame = TimerFrame;
+        return true;
+    }
+    return false;
+}
+
+void EndContextTimer(int32 contextIndex)
+{
+    if (contextIndex == -1)
+        return;
+
+    ContextTimer& timer = ContextTimers[FrameContexts[contextIndex]];
+    timer.queries[timer.active]->End();
+    timer.pending[timer.active] = true;
+}
+
+void ReadContextTimers()
+{
+    for (auto i = ContextTimers.Begin(); i.IsNotEnd(); ++i)
+    {
+        ContextTimer& timer = i->Value;
+        for (int32 slot = 0; slot < TIMER_QUERY_SLOTS; slot++)
+        {
+            if (!timer.pending[slot] || !timer.queries[slot]->HasResult())
+                continue;
+
+            timer.gpuTime = timer.queries[slot]->GetResult();
+            timer.pending[slot] = false;
+        }
+
+        // Timers of contexts which are no longer rendered are released, so a context created later at the same address starts without the old result
+        if (TimerFrame - timer.frame > TRIM_INTERVAL && !timer.IsPending())
+        {
+            timer.Dispose();
+            ContextTimers.Remove(i);
+        }
+    }
+}
+
+FlaxRenderStats& GetContextStats(int32 contextIndex)
+{
+    while (ContextStats.Count() <= contextIndex)
+        ContextStats.Add(FlaxRenderStats());
+    return ContextStats[contextIndex];
+}
+
+void ClearRecordedDraws()
+{
+    RecordedDraws.Clear();
+    RecordedTransforms.Clear();
+    BatchVertexBuffer->Clear();
+    BatchIndexBuffer->Clear();
+}
+
+void FlushRecordedDraws()
+{
+    if (RecordedDraws.IsEmpty())
+        return;
+
+    RMLUI_PROFILE_GPU_CPU(PerFrame, "RmlUi.FlushDraws");
+
+    if (!Headless && InitPipelines())
+    {
+        ClearRecordedDraws();
+        return;
+    }
+
+    if (ReorderDraws)
+        ReorderRecordedDraws();
+    BuildDrawSubmits();
+    Stats.RecordedDraws += RecordedDraws.Count();
+    Stats.DrawCalls += DrawSubmits.Count();
+    for (const RecordedDraw& draw : RecordedDraws)
+        GetContextStats(draw.context).RecordedDraws++;
+    Stats.MergedDraws += RecordedDraws.Count() - DrawSubmits.Count();
+
+    GPUConstantBuffer* constantBuffer = nullptr;
+    GPUTexture* whiteTexture = nullptr;
+    const Rectangle viewportBounds(CurrentViewport.Location, CurrentViewport.Size);
+    if (!Headless)
+    {
+        BatchVertexBuffer->Flush(CurrentGPUContext);
+        BatchIndexBuffer->Flush(CurrentGPUContext);
+
+        constantBuffer = BasicShader->GetShader()->GetCB(0);
+        whiteTexture = GPUDevice::Instance->GetDefaultWhiteTexture();
+        CurrentGPUContext->ResetSR();
+        CurrentGPUContext->SetRenderTarget(CurrentRenderContext->Task->GetOutputView());
+        CurrentGPUContext->SetViewport(CurrentViewport);
+        CurrentGPUContext->FlushState();
+        CurrentGPUContext->BindCB(0, constantBuffer);
+    }
+
+    // Submits merged from draws of multiple contexts are attributed to the context of the first draw, their vertices to the context of each draw
+    int32 timedContext = -1;
+    for (int32 submitIndex = 0; submitIndex < DrawSubmits.Count(); submitIndex++)
+    {
+        const DrawSubmit& submit = DrawSubmits[submitIndex];
+        const RecordedDraw& draw = RecordedDraws[submit.first];
+        const FlaxDrawCommand command = DescribeSubmit(submitIndex);
+        FlaxRenderStats& contextStats = GetContextStats(draw.context);
+        contextStats.DrawCalls++;
+        if (draw.geometry == nullptr)
+        {
+            const int32 drawEnd = submitIndex + 1 < DrawSubmits.Count() ? DrawSubmits[submitIndex + 1].first : RecordedDraws.Count();
+            for (int32 i = submit.first; i < drawEnd; i++)
+            {
+                FlaxRenderStats& drawStats = GetContextStats(RecordedDraws[i].context);
+                drawStats.Vertices += RecordedDraws[i].vertexCount;
+                drawStats.Indices += RecordedDraws[i].indexCount;
+            }
+        }
+        else
+        {
+            contextStats.Vertices += command.VertexCount;
+            contextStats.Indices += command.IndexCount;
+        }
+        contextStats.TextureBinds += command.TextureBinds;
+        contextStats.StateChanges += command.StateChanged ? 1 : 0;
+        Stats.Vertices += command.VertexCount;
+        Stats.Indices += command.IndexCount;
+        Stats.TextureBinds += command.TextureBinds;
+        Stats.StateChanges += command.StateChanged ? 1 : 0;
+        if (Headless)
+        {
+            HeadlessCommands.Add(command);
+            continue;
+        }
+
+        if (draw.context != timedContext)
+        {
+            EndContextTimer(timedContext);
+            timedContext = BeginContextTimer(draw.context) ? draw.context : -1;
+        }
+        CompiledGeometry* compiledGeometry = draw.geometry;
+
+        CustomData data;
+        Matrix::Transpose(ViewProjection, data.ViewProjection);
+        Matrix::Transpose(RecordedTransforms[draw.transformIndex], data.Model);
+        data.Offset = draw.translation;
+        data.SdfParams = draw.sdfParams;
+        CurrentGPUContext->UpdateCB(constantBuffer, &data);
+
+        CurrentGPUContext->SetScissor(compiledGeometry != nullptr ? draw.scissor : viewportBounds);
+        const int32 slotCount = submit.pipeline == DrawPipeline::Basic || submit.pipeline == DrawPipeline::BasicNoClip ? TextureSlotCount : 1;
+        for (int32 slot = 0; slot < slotCount; slot++)
+            CurrentGPUContext->BindSR(slot, slot < submit.textureCount ? submit.textures[slot] : whiteTexture);
+        CurrentGPUContext->SetState(Pipelines[(int32)submit.pipeline]);
+        if (compiledGeometry == nullptr)
+        {
+            GPUBuffer* vb = BatchVertexBuffer->GetBuffer();
+            CurrentGPUContext->BindVB(Span<GPUBuffer*>(&vb, 1));
+            CurrentGPUContext->BindIB(BatchIndexBuffer->GetBuffer());
+            CurrentGPUContext->DrawIndexed(submit.indexCount, 0, draw.indexStart);
+        }
+        else if (compiledGeometry->isGlyphs)
+        {
+            GPUBuffer* vbs[2] = { GlyphQuadVertexBuffer, compiledGeometry->glyphBuffer.GetBuffer() };
+            CurrentGPUContext->BindVB(Span<GPUBuffer*>(vbs, 2));
+            CurrentGPUContext->BindIB(GlyphQuadIndexBuffer);
+            CurrentGPUContext->DrawIndexedInstanced(6, compiledGeometry->glyphCount);
+        }
+        else
+        {
+            GPUBuffer* vb = compiledGeometry->vertexBuffer.GetBuffer();
+            CurrentGPUContext->BindVB(Span<GPUBuffer*>(&vb, 1));
+            CurrentGPUContext->BindIB(compiledGeometry->indexBuffer.GetBuffer());
+            CurrentGPUContext->DrawIndexed(compiledGeometry->indexCount);
+        }
+    }
+    EndContextTimer(timedContext);
+    ClearRecordedDraws();
+}
+
+bool InitGlyphQuadBuffers()
+{
+    if (GlyphQuadVertexBuffer != nullptr)
+        return false;
 
-struct CompiledGeometry
+    // Corners and winding match the quads written by the font engine
+    const Float2 corners[4] = { Float2(1, 1), Float2(0, 1), Float2(0, 0), Float2(1, 0) };
+    const uint16 indices[6] = { 0, 1, 2, 2, 3, 0 };
+
+    GlyphQuadVertexBuffer = GPUDevice::Instance->CreateBuffer(TEXT("RmlUi.GlyphQuadVB"));
+    if (GlyphQuadVertexBuffer->Init(GPUBufferDescription::Vertex(sizeof(Float2), 4, corners)))
+    {
+        LOG(Error, "RmlUi: Failed to create glyph quad vertex buffer");
+        return true;
+    }
+    GlyphQuadIndexBuffer = GPUDevice::Instance->CreateBuffer(TEXT("RmlUi.GlyphQuadIB"));
+    if (GlyphQuadIndexBuffer->Init(GPUBufferDescription::Index(sizeof(uint16), 6, indices)))
+    {
+        LOG(Error, "RmlUi: Failed to create glyph quad index buffer");
+        return true;
+    }
+    return false;
+}
+
+// Converts text geometry made of axis-aligned quads into glyph instances, returns false if the geometry has a different layout
+bool BuildGlyphInstances(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Array<GlyphInstance>& output)
 {
-public:
-    CompiledGeometry()
-        : reserved(true)
-        , vertexBuffer(512, sizeof(BasicVertex), TEXT("RmlUI.VB"))
-        , indexBuffer(64, sizeof(uint32), TEXT("RmlUI.IB"))
-        , texture(nullptr)
-        , isFont(false)
+    const int numQuads = num_vertices / 4;
+    if (num_vertices == 0 || num_vertices != numQuads * 4 || num_indices != numQuads * 6)
+        return false;
+
+    for (int i = 0; i < numQuads; i++)
     {
+        const int base = i * 4;
+        const int* quadIndices = indices + i * 6;
+        if (quadIndices[0] != base + 0 || quadIndices[1] != base + 1 || quadIndices[2] != base + 2 ||
+            quadIndices[3] != base + 2 || quadIndices[4] != base + 3 || quadIndices[5] != base + 0)
+            return false;
+
+        const Rml::Vertex& bottomRight = vertices[base + 0];
+        const Rml::Vertex& bottomLeft = vertices[base + 1];
+        const Rml::Vertex& upperLeft = vertices[base + 2];
+        const Rml::Vertex& upperRight = vertices[base + 3];
+        if (bottomLeft.position.x != upperLeft.position.x || bottomLeft.position.y != bottomRight.position.y ||
+            upperRight.position.x != bottomRight.position.x || upperRight.position.y != upperLeft.position.y ||
+            bottomRight.colour != upperLeft.colour || bottomLeft.colour != upperLeft.colour || upperRight.colour != upperLeft.colour)
+            return false;
     }
 
-    ~CompiledGeometry()
+    output.Resize(numQuads, false);
+    for (int i = 0; i < numQuads; i++)
     {
-        Dispose(false);
+        const Rml::Vertex& bottomRight = vertices[i * 4 + 0];
+        const Rml::Vertex& upperLeft = vertices[i * 4 + 2];
+
+        GlyphInstance& instance = output[i];
+        instance.Rect = Float4(upperLeft.position.x, upperLeft.position.y, bottomRight.position.x - upperLeft.position.x, bottomRight.position.y - upperLeft.position.y);
+        instance.UVRect = Half4(upperLeft.tex_coord.x, upperLeft.tex_coord.y, bottomRight.tex_coord.x, bottomRight.tex_coord.y);
+        instance.Color = Color32(upperLeft.colour.red, upperLeft.colour.green, upperLeft.colour.blue, upperLeft.colour.alpha);
     }
+    return true;
+}
 
-    void Dispose(bool preserveBuffers = true)
+bool CompileGlyphs(CompiledGeometry* compiledGeometry, const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices)
+{
+    if (!BuildGlyphInstances(vertices, num_vertices, indices, num_indices, GlyphScratch))
+        return false;
+
+    compiledGeometry->isGlyphs = true;
+    compiledGeometry->glyphCount = GlyphScratch.Count();
+    AcquireStagingData(compiledGeometry->glyphBuffer.Data, GlyphScratch.Count() * sizeof(GlyphInstance));
+    compiledGeometry->glyphBuffer.Data.Set((const byte*)GlyphScratch.Get(), GlyphScratch.Count() * sizeof(GlyphInstance));
+    return true;
+}
+
+// Compares the data with the staging data of the geometry when it is still kept, geometry without the staging data is trusted to the hash
+bool MatchesStagingData(const CompiledGeometry* geometry, const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture_handle)
+{
+    if (geometry->isGlyphs)
     {
-        reserved = false;
-        texture = nullptr;
-        if (preserveBuffers)
+        const Array<byte>& data = geometry->glyphBuffer.Data;
+        if (data.IsEmpty())
+            return true;
+        return BuildGlyphInstances(vertices, num_vertices, indices, num_indices, GlyphScratch) && data.Count() == GlyphScratch.Count() * (int32)sizeof(GlyphInstance) &&
+               Platform::MemoryCompare(data.Get(), GlyphScratch.Get(), data.Count()) == 0;
+    }
+
+    const Array<byte>& vertexData = geometry->vertexBuffer.Data;
+    const Array<byte>& indexData = geometry->indexBuffer.Data;
+    if (vertexData.IsEmpty() || indexData.IsEmpty())
+        return true;
+    if (vertexData.Count() != num_vertices * (int32)sizeof(BasicVertex) || indexData.Count() != num_indices * (int32)sizeof(uint32))
+        return false;
+
+    Float2 sdfParams;
+    const DrawMode mode = GetDrawMode(texture_handle, sdfParams);
+    const BasicVertex* keptVertices = (const BasicVertex*)vertexData.Get();
+    for (int i = 0; i < num_vertices; i++)
+    {
+        const BasicVertex vertex = ConvertVertex(vertices[i], mode, sdfParams);
+        if (Platform::MemoryCompare(&vertex, &keptVertices[i], sizeof(BasicVertex)) != 0)
+            return false;
+    }
+    const uint32* keptIndices = (const uint32*)indexData.Get();
+    for (int i = 0; i < num_indices; i++)
+    {
+        if (keptIndices[i] != (uint32)indices[i])
+            return false;
+    }
+    return true;
+}
+
+// Shares the geometry compiled from identical data, released geometry which is not reused yet is taken back
+bool FindGeometry(Rml::CompiledGeometryHandle& geometryHandle, const GeometryKey& key, const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture_handle)
+{
+    int32 index;
+    if (!GeometryHashes.TryGet(key, index) || !MatchesStagingData(GeometryCache[index], vertices, num_vertices, indices, num_indices, texture_handle))
+        return false;
+
+    CompiledGeometry* geometry = GeometryCache[index];
+    if (geometry->reserved)
+        geometry->refCount++;
+    else
+    {
+        UnlinkReleasedGeometry(index);
+        UnregisterPatchableGlyphs(index);
+        geometry->reserved = true;
+        geometry->refCount = 1;
+    }
+    geometryHandle = Rml::CompiledGeometryHandle(index);
+    return true;
+}
+
+// Finds the most recently released glyph geometry with the same texture and glyph count, and rewrites only the glyphs which differ
+bool PatchGlyphs(Rml::CompiledGeometryHandle& geometryHandle, const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture_handle)
+{
+    GPUTexture* texture = LoadedTextures.At((int32)texture_handle);
+    if (num_vertices > PATCH_GLYPHS_MAX * 4 || num_vertices % 4 != 0 || !FontTextures.Contains(texture))
+        return false;
+
+    GlyphPatchKey key = { texture, num_vertices / 4, false, Float2::Zero };
+    key.isSdf = SdfTextureParams.TryGet(texture_handle, key.sdfParams);
+    const Array<int32>* patchable = PatchableGlyphs.TryGet(key);
+    if (patchable == nullptr || patchable->IsEmpty() || !BuildGlyphInstances(vertices, num_vertices, indices, num_indices, GlyphScratch))
+        return false;
+
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.PatchGlyphs");
+
+    const int32 index = patchable->Last();
+    CompiledGeometry* compiledGeometry = GeometryCache[index];
+    geometryHandle = Rml::CompiledGeometryHandle(index);
+    UnlinkReleasedGeometry(index);
+    UnregisterPatchableGlyphs(index);
+    compiledGeometry->reserved = true;
+    compiledGeometry->bounds = GetGeometryBounds(vertices, num_vertices);
+    compiledGeometry->refCount = 1;
+    GlyphInstance* glyphs = (GlyphInstance*)compiledGeometry->glyphBuffer.Data.Get();
+    for (int32 i = 0; i < GlyphScratch.Count(); i++)
+    {
+        if (Platform::MemoryCompare(&glyphs[i], &GlyphScratch[i], sizeof(GlyphInstance)) == 0)
+            continue;
+
+        glyphs[i] = GlyphScratch[i];
+        const int32 start = i * sizeof(GlyphInstance);
+        const int32 end = start + sizeof(GlyphInstance);
+        if (compiledGeometry->glyphDirtyEnd == compiledGeometry->glyphDirtyStart)
         {
-            vertexBuffer.Clear();
-            indexBuffer.Clear();
+            compiledGeometry->glyphDirtyStart = start;
+            compiledGeometry->glyphDirtyEnd = end;
         }
         else
         {
-            vertexBuffer.Dispose();
-            indexBuffer.Dispose();
+            compiledGeometry->glyphDirtyStart = Math::Min(compiledGeometry->glyphDirtyStart, start);
+            compiledGeometry->glyphDirtyEnd = Math::Max(compiledGeometry->glyphDirtyEnd, end);
         }
-        isFont = false;
     }
+    return true;
+}
 
-    bool reserved;
-    StaticVertexBuffer vertexBuffer;
-    StaticIndexBuffer indexBuffer;
-    GPUTexture* texture;
-    bool isFont;
-};
+void ReleaseGeometry(Rml::CompiledGeometryHandle handle)
+{
+    if ((int)handle == 0)
+        return;
+    CompiledGeometry* geometry = GeometryCache[(int)handle];
+    if (--geometry->refCount > 0)
+        return;
+    geometry->Release();
+    LinkReleasedGeometry((int32)handle);
+    RegisterPatchableGlyphs((int32)handle);
+    Stats.ReleasedGeometries++;
+}
 
-PACK_STRUCT(struct CustomData
+void AddBufferMemory(RmlUiMemoryUsage& usage, const DynamicBuffer& buffer)
 {
-    Matrix ViewProjection;
-    Matrix Model;
-    Float2 Offset;
-    Float2 Dummy;
-});
+    // The data of the buffer is kept on CPU after it was uploaded
+    usage.CPUMemory += buffer.Data.Capacity();
+    if (buffer.GetBuffer() != nullptr)
+        usage.GPUMemory += buffer.GetBuffer()->GetMemoryUsage();
+}
 
-namespace
+void AddGeometryMemory(RmlUiMemoryUsage& usage, const CompiledGeometry* geometry)
 {
-    RenderContext* CurrentRenderContext = nullptr;
-    GPUContext* CurrentGPUContext = nullptr;
-    Viewport CurrentViewport;
-    Rectangle CurrentScissor;
-    Matrix CurrentTransform;
-    Matrix ViewProjection;
-    bool UseScissor = false;
-    AssetReference<Shader> BasicShader;
-    GPUPipelineState* FontPipeline = nullptr;
-    GPUPipelineState* ImagePipeline = nullptr;
-    GPUPipelineState* ColorPipeline = nullptr;
-    Array<CompiledGeometry*> GeometryCache(2);
-    Dictionary<GPUTexture*, AssetReference<Texture>> LoadedTextureAssets(32);
-    Array<GPUTexture*> LoadedTextures(32);
-    Array<GPUTexture*> AllocatedTextures(32);
-    HashSet<GPUTexture*> FontTextures(32);
-#if !USE_RMLUI_6_0
-    Dictionary<byte*, Rml::TextureHandle> AtlasGenerateTextureHandles;
-#endif
+    usage.Count++;
+    AddBufferMemory(usage, geometry->vertexBuffer);
+    AddBufferMemory(usage, geometry->indexBuffer);
+    AddBufferMemory(usage, geometry->glyphBuffer);
 }
 
-CompiledGeometry* ReserveGeometry(Rml::CompiledGeometryHandle& geometryHandle)
+uint64 GetGeometryMemory(const CompiledGeometry* geometry)
 {
-    // Cache geometry structures in order to reduce allocations and recreating buffers
-    for (int i = 1; i < GeometryCache.Count(); i++)
+    RmlUiMemoryUsage usage;
+    AddGeometryMemory(usage, geometry);
+    return usage.GPUMemory + usage.CPUMemory;
+}
+
+// Frees the buffers of released geometry and lists the slot as empty
+void FreeGeometry(int32 index)
+{
+    UnlinkReleasedGeometry(index);
+    UnregisterGeometryKey(index);
+    UnregisterPatchableGlyphs(index);
+    GeometryCache[index]->Dispose(false);
+    FreeGeometrySlots.Add(index);
+}
+
+// Frees the buffers of released geometry unused for the given number of frames, then of the least recently used released geometry
+// until the cache fits in the budget. Geometry in use is never freed, released geometry can't be taken back once freed.
+void TrimGeometryCache(int32 unusedFrames, uint64 budget)
+{
+    RMLUI_PROFILE_CPU(PerFrame, "RmlUi.TrimGeometryCache");
+
+    uint64 cacheMemory = 0;
+    if (budget != 0)
     {
-        if (GeometryCache[i]->reserved)
-            continue;
+        for (int32 i = 1; i < GeometryCache.Count(); i++)
+            cacheMemory += GetGeometryMemory(GeometryCache[i]);
+    }
 
-        GeometryCache[i]->reserved = true;
-        geometryHandle = Rml::CompiledGeometryHandle(i);
-        return GeometryCache[i];
+    // Released geometry is listed from the least recently used
+    while (ReleasedGeometryFirst != 0)
+    {
+        const CompiledGeometry* geometry = GeometryCache[ReleasedGeometryFirst];
+        const bool unused = unusedFrames >= 0 && TimerFrame - geometry->lastUsedFrame >= unusedFrames;
+        if (!unused && cacheMemory <= budget)
+            break;
+        if (budget != 0)
+            cacheMemory -= GetGeometryMemory(geometry);
+        FreeGeometry(ReleasedGeometryFirst);
     }
 
-    CompiledGeometry* geometry = New<CompiledGeometry>();
-    geometryHandle = Rml::CompiledGeometryHandle(GeometryCache.Count());
-    GeometryCache.Add(geometry);
-    return geometry;
+    // Handles are indices to the cache, only the empty slots at the end can be removed
+    while (GeometryCache.Count() > 1 && !GeometryCache.Last()->reserved && !GeometryCache.Last()->released)
+    {
+        const int32 position = FreeGeometrySlots.Find(GeometryCache.Count() - 1);
+        if (position != -1)
+            FreeGeometrySlots.RemoveAt(position);
+        Delete(GeometryCache.Last());
+        GeometryCache.RemoveLast();
+    }
 }
 
-void ReleaseGeometry(Rml::CompiledGeometryHandle handle)
+// Reused geometry slots keep the GPU buffers sized for the largest geometry compiled into them, recreate buffers much larger than the new data
+void ShrinkBuffer(DynamicBuffer& buffer)
 {
-    if ((int)handle == 0)
-        return;
-    GeometryCache[(int)handle]->Dispose();
+    GPUBuffer* gpuBuffer = buffer.GetBuffer();
+    if (gpuBuffer != nullptr && gpuBuffer->GetSize() > SHRINK_MIN_SIZE && gpuBuffer->GetSize() > (uint32)buffer.Data.Count() * SHRINK_RATIO)
+        gpuBuffer->ReleaseGPU();
 }
 
-FlaxRenderInterface::FlaxRenderInterface() : RenderInterface()
+FlaxRenderInterface::FlaxRenderInterface(bool headless) : RenderInterface()
 {
     UseScissor = true;
+    Headless = headless;
 
-    Guid basicShaderGuid;
-    Guid::Parse(StringAnsiView(RMLUI_PLUGIN_BASIC_SHADER), basicShaderGuid);
-    BasicShader = Content::Load<Shader>(basicShaderGuid);
-    if (!BasicShader)
-        LOG(Error, "RmlUi: Failed to load shader with id {0}", basicShaderGuid.ToString());
-    BasicShader.Get()->OnReloading.Bind<FlaxRenderInterface, &FlaxRenderInterface::InvalidateShaders>(this);
+    // Headless rendering records the draw calls without any GPU resources
+    if (!Headless)
+    {
+        Guid basicShaderGuid;
+        Guid::Parse(StringAnsiView(RMLUI_PLUGIN_BASIC_SHADER), basicShaderGuid);
+        BasicShader = Content::LoadAsync<Shader>(basicShaderGuid);
+        if (!BasicShader)
+            LOG(Error, "RmlUi: Failed to load shader with id {0}", basicShaderGuid.ToString());
+        else
+            BasicShader.Get()->OnReloading.Bind<FlaxRenderInterface, &FlaxRenderInterface::InvalidateShaders>(this);
+    }
 
     // Handles with value of 0 are invalid, reserve the first slot in the arrays
     LoadedTextures.Add(nullptr);
     GeometryCache.Add(nullptr);
+
+    TextureSlotCount = Math::Clamp(RmlUiSettings::Get()->BatchTextureSlots, 1, MAX_TEXTURE_SLOTS);
+    TrimUnusedFrames = RmlUiSettings::Get()->GeometryCacheUnusedFrames > 0 ? RmlUiSettings::Get()->GeometryCacheUnusedFrames : -1;
+    TrimBudget = (uint64)Math::Max(RmlUiSettings::Get()->GeometryCacheBudget, 0) * 1024 * 1024;
+    ReorderDraws = RmlUiSettings::Get()->ReorderDraws;
+    BatchVertexBuffer = New<DynamicVertexBuffer>(64 * 1024, (uint32)sizeof(BasicVertex), TEXT("RmlUi.BatchVB"));
+    BatchIndexBuffer = New<DynamicIndexBuffer>(16 * 1024, (uint32)sizeof(uint32), TEXT("RmlUi.BatchIB"));
 }
 
 FlaxRenderInterface::~FlaxRenderInterface()
 {
-    BasicShader.Get()->OnReloading.Unbind<FlaxRenderInterface, &FlaxRenderInterface::InvalidateShaders>(this);
+    if (BasicShader)
+        BasicShader.Get()->OnReloading.Unbind<FlaxRenderInterface, &FlaxRenderInterface::InvalidateShaders>(this);
     InvalidateShaders();
+    Delete(BatchVertexBuffer);
+    Delete(BatchIndexBuffer);
+    BatchVertexBuffer = nullptr;
+    BatchIndexBuffer = nullptr;
 }
 
 void FlaxRenderInterface::InvalidateShaders(Asset* obj)
 {
-    SAFE_DELETE_GPU_RESOURCE(FontPipeline);
-    SAFE_DELETE_GPU_RESOURCE(ImagePipeline);
-    SAFE_DELETE_GPU_RESOURCE(ColorPipeline);
+    for (GPUPipelineState*& pipeline : Pipelines)
+        SAFE_DELETE_GPU_RESOURCE(pipeline);
 }
 
 void FlaxRenderInterface::RenderGeometry(Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture_handle, const Rml::Vector2f& translation)
 {
-    CompiledGeometry compiledGeometry;
-    CompileGeometry(&compiledGeometry, vertices, num_vertices, indices, num_indices, texture_handle);
-    RenderCompiledGeometry(&compiledGeometry, translation);
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.RenderGeometry");
+
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureRenderGeometry(vertices, num_vertices, indices, num_indices, texture_handle, translation);
+
+    // Immediate geometry is always copied to the frame batch
+    Float2 sdfParams;
+    const DrawMode mode = GetDrawMode(texture_handle, sdfParams);
+    static Array<BasicVertex> convertedVertices;
+    convertedVertices.Resize(num_vertices, false);
+    for (int i = 0; i < num_vertices; i++)
+        convertedVertices[i] = ConvertVertex(vertices[i], mode, sdfParams);
+
+    RecordedDraw& draw = RecordDraw(DrawPipeline::Basic, LoadedTextures.At((int32)texture_handle), Float2::Zero);
+    BatchVertices(convertedVertices.Get(), num_vertices, indices, num_indices, (Float2)translation, draw);
 }
 
 Rml::CompiledGeometryHandle FlaxRenderInterface::CompileGeometry(Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture_handle)
@@ -184,43 +1577,62 @@ Rml::CompiledGeometryHandle FlaxRenderInterface::CompileGeometry(Rml::Vertex* ve
     return {};
 #endif
 
+    // Recompiling unchanged geometry costs only the hash
+    const bool timed = RmlUiProfileScope::IsEnabled(RmlUiInstrumentationLevel::PerDraw);
+    const double startTime = timed ? Platform::GetTimeSeconds() : 0.0;
+    const GeometryKey key = GetGeometryKey(vertices, num_vertices, indices, num_indices, texture_handle);
     Rml::CompiledGeometryHandle geometryHandle;
-    CompiledGeometry* compiledGeometry = ReserveGeometry(geometryHandle);
-    CompileGeometry(compiledGeometry, vertices, num_vertices, indices, num_indices, texture_handle);
-    return (Rml::CompiledGeometryHandle)geometryHandle;
+    if (FindGeometry(geometryHandle, key, vertices, num_vertices, indices, num_indices, texture_handle))
+        Stats.SharedGeometries++;
+    else
+    {
+        if (!PatchGlyphs(geometryHandle, vertices, num_vertices, indices, num_indices, texture_handle))
+        {
+            CompiledGeometry* compiledGeometry = ReserveGeometry(geometryHandle);
+            CompileGeometry(compiledGeometry, vertices, num_vertices, indices, num_indices, texture_handle);
+        }
+        GeometryCache[(int32)geometryHandle]->context = CurrentContext;
+        RegisterGeometryKey((int32)geometryHandle, key);
+        Stats.CompiledGeometries++;
+    }
+    GeometryCache[(int32)geometryHandle]->lastUsedFrame = TimerFrame;
+    if (timed)
+        Stats.CompileTime += Platform::GetTimeSeconds() - startTime;
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureCompileGeometry(vertices, num_vertices, indices, num_indices, texture_handle, geometryHandle);
+    return geometryHandle;
 }
 
 void FlaxRenderInterface::CompileGeometry(CompiledGeometry* compiledGeometry, Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture_handle)
 {
-    PROFILE_GPU_CPU("RmlUi.CompileGeometry");
-
-    const Rectangle defaultBounds(CurrentViewport.Location, CurrentViewport.Size);
-    const RotatedRectangle defaultMask(defaultBounds);
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.CompileGeometry");
 
     compiledGeometry->texture = LoadedTextures.At((int32)texture_handle);
-    compiledGeometry->vertexBuffer.Data.EnsureCapacity((int32)(num_vertices * sizeof(BasicVertex)));
-    compiledGeometry->indexBuffer.Data.EnsureCapacity((int32)(num_indices * sizeof(uint32)));
+    compiledGeometry->vertexCount = num_vertices;
+    compiledGeometry->indexCount = num_indices;
 
     // FIXME: hacky way to detect if we are rendering text or images
     compiledGeometry->isFont = FontTextures.Contains(compiledGeometry->texture);
+    compiledGeometry->isSdf = SdfTextureParams.TryGet(texture_handle, compiledGeometry->sdfParams);
+    compiledGeometry->bounds = GetGeometryBounds(vertices, num_vertices);
+    if (compiledGeometry->isFont && CompileGlyphs(compiledGeometry, vertices, num_vertices, indices, num_indices))
+        return;
 
+    AcquireStagingData(compiledGeometry->vertexBuffer.Data, (int32)(num_vertices * sizeof(BasicVertex)));
+    AcquireStagingData(compiledGeometry->indexBuffer.Data, (int32)(num_indices * sizeof(uint32)));
+    Float2 sdfParams;
+    const DrawMode mode = GetDrawMode(texture_handle, sdfParams);
     for (int i = 0; i < num_vertices; i++)
-    {
-        BasicVertex vb0;
-        vb0.Position = (Float2)vertices[i].position;
-        vb0.TexCoord = Half2((Float2)vertices[i].tex_coord);
-        vb0.Color = Color(Color32(vertices[i].colour.red, vertices[i].colour.green, vertices[i].colour.blue, vertices[i].colour.alpha));
-        vb0.ClipOrigin = Float2::Zero;
-        vb0.ClipMask = defaultMask;
-
-        compiledGeometry->vertexBuffer.Write(vb0);
-    }
+        compiledGeometry->vertexBuffer.Write(ConvertVertex(vertices[i], mode, sdfParams));
     for (int i = 0; i < num_indices; i++)
         compiledGeometry->indexBuffer.Write((uint32)indices[i]);
 }
 
 void FlaxRenderInterface::RenderCompiledGeometry(Rml::CompiledGeometryHandle geometry, const Rml::Vector2f& translation)
 {
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureRenderCompiledGeometry(geometry, translation);
+
     CompiledGeometry* compiledGeometry = GeometryCache[(int)geometry];
     if (compiledGeometry == nullptr)
         return;
@@ -230,103 +1642,95 @@ void FlaxRenderInterface::RenderCompiledGeometry(Rml::CompiledGeometryHandle geo
 
 void FlaxRenderInterface::RenderCompiledGeometry(CompiledGeometry* compiledGeometry, const Rml::Vector2f& translation)
 {
-    PROFILE_GPU_CPU("RmlUi.RenderCompiledGeometry");
+    RMLUI_PROFILE_CPU(PerDraw, "RmlUi.RenderCompiledGeometry");
 
-    compiledGeometry->vertexBuffer.Flush(CurrentGPUContext);
-    compiledGeometry->indexBuffer.Flush(CurrentGPUContext);
+    compiledGeometry->lastUsedFrame = TimerFrame;
 
-    if (!BasicShader->IsLoaded() && BasicShader->WaitForLoaded())
+    // Skip geometry scrolled out of its clipping container or moved off-screen
+    if (IsGeometryCulled(compiledGeometry->bounds, (Float2)translation))
+    {
+        Stats.CulledDraws++;
         return;
+    }
 
-    // Setup pipelines
-    if (FontPipeline == nullptr || ImagePipeline == nullptr || ColorPipeline == nullptr)
-    {
-        bool useDepth = false;
-        GPUPipelineState::Description desc = GPUPipelineState::Description::DefaultFullscreenTriangle;
-        desc.DepthEnable = desc.DepthWriteEnable = useDepth;
-        desc.DepthWriteEnable = false;
-        desc.DepthClipEnable = false;
-        desc.VS = BasicShader->GetShader()->GetVS("VS");
-        desc.PS = BasicShader->GetShader()->GetPS("PS_Font");
-        desc.CullMode = CullMode::TwoSided;
-        desc.BlendMode = BlendingMode::AlphaBlend;
-
-        FontPipeline = GPUDevice::Instance->CreatePipelineState();
-        if (FontPipeline->Init(desc))
-        {
-            LOG(Error, "RmlUi: Failed to create font pipeline state");
-            return;
-        }
+    if (compiledGeometry->isGlyphs && compiledGeometry->glyphCount <= PATCH_GLYPHS_MAX)
+    {
+        // Patched glyphs are read from the kept data each frame, so there is no GPU range to upload
+        compiledGeometry->glyphDirtyStart = compiledGeometry->glyphDirtyEnd = 0;
+        BatchGlyphs(compiledGeometry, (Float2)translation);
+        return;
+    }
+    if (!compiledGeometry->isGlyphs && compiledGeometry->vertexCount <= BATCH_MAX_VERTICES)
+    {
+        // Small geometry is copied to the frame batch and doesn't need its own GPU buffers
+        RecordedDraw& draw = RecordDraw(DrawPipeline::Basic, compiledGeometry->texture, Float2::Zero);
+        BatchVertices((const BasicVertex*)compiledGeometry->vertexBuffer.Data.Get(), compiledGeometry->vertexCount,
+                      (const int*)compiledGeometry->indexBuffer.Data.Get(), compiledGeometry->indexCount,
+                      (Float2)translation, draw);
+        return;
+    }
 
-        desc.PS = BasicShader->GetShader()->GetPS("PS_Image");
-        ImagePipeline = GPUDevice::Instance->CreatePipelineState();
-        if (ImagePipeline->Init(desc))
+    // Upload the geometry once after compiling, patched glyphs upload only the changed range
+    if (!Headless)
+    {
+        if (compiledGeometry->dirty)
         {
-            LOG(Error, "RmlUi: Failed to create image pipeline state");
-            return;
+            if (compiledGeometry->isGlyphs)
+            {
+                ShrinkBuffer(compiledGeometry->glyphBuffer);
+                compiledGeometry->glyphBuffer.Flush(CurrentGPUContext);
+            }
+            else
+            {
+                ShrinkBuffer(compiledGeometry->vertexBuffer);
+                ShrinkBuffer(compiledGeometry->indexBuffer);
+                compiledGeometry->vertexBuffer.Flush(CurrentGPUContext);
+                compiledGeometry->indexBuffer.Flush(CurrentGPUContext);
+            }
+            compiledGeometry->dirty = false;
+
+            // The GPU buffers are not updated again, so the static geometry doesn't need to keep a copy of its data
+            if (!compiledGeometry->KeepsStagingData())
+            {
+                ReleaseStagingData(compiledGeometry->vertexBuffer.Data);
+                ReleaseStagingData(compiledGeometry->indexBuffer.Data);
+                ReleaseStagingData(compiledGeometry->glyphBuffer.Data);
+            }
         }
-
-        desc.PS = BasicShader->GetShader()->GetPS("PS_Color");
-        ColorPipeline = GPUDevice::Instance->CreatePipelineState();
-        if (ColorPipeline->Init(desc))
+        else if (compiledGeometry->glyphDirtyEnd > compiledGeometry->glyphDirtyStart)
         {
-            LOG(Error, "RmlUi: Failed to create color pipeline state");
-            return;
+            const int32 start = compiledGeometry->glyphDirtyStart;
+            CurrentGPUContext->UpdateBuffer(compiledGeometry->glyphBuffer.GetBuffer(), compiledGeometry->glyphBuffer.Data.Get() + start, compiledGeometry->glyphDirtyEnd - start, start);
         }
+        compiledGeometry->glyphDirtyStart = compiledGeometry->glyphDirtyEnd = 0;
+        if (compiledGeometry->isGlyphs && InitGlyphQuadBuffers())
+            return;
     }
 
-    GPUPipelineState* pipeline;
-    if (compiledGeometry->texture == nullptr)
-        pipeline = ColorPipeline;
-    else if (compiledGeometry->isFont)
-        pipeline = FontPipeline;
-    else
-        pipeline = ImagePipeline;
-    GPUConstantBuffer* constantBuffer = BasicShader->GetShader()->GetCB(0);
-    GPUBuffer* vb = compiledGeometry->vertexBuffer.GetBuffer();
-    GPUBuffer* ib = compiledGeometry->indexBuffer.GetBuffer();
-
-    CurrentGPUContext->ResetSR();
-    CurrentGPUContext->SetRenderTarget(CurrentRenderContext->Task->GetOutputView());
-    if (UseScissor)
-    {
-        CurrentGPUContext->SetViewport(CurrentViewport);
-        CurrentGPUContext->SetScissor(CurrentScissor);
-    }
-    else
-        CurrentGPUContext->SetViewportAndScissors(CurrentViewport);
-    CurrentGPUContext->FlushState();
-
-    // Update constant buffer data
-    CustomData data;
-    Matrix::Transpose(ViewProjection, data.ViewProjection);
-    Matrix::Transpose(CurrentTransform, data.Model);
-    data.Offset = (Float2)translation;
-    CurrentGPUContext->UpdateCB(constantBuffer, &data);
-
-    // State and bindings
-    CurrentGPUContext->BindCB(0, constantBuffer);
-    if (compiledGeometry->texture != nullptr)
-        CurrentGPUContext->BindSR(0, compiledGeometry->texture);
-    CurrentGPUContext->BindVB(Span<GPUBuffer*>(&vb, 1));
-    CurrentGPUContext->BindIB(ib);
-    CurrentGPUContext->SetState(pipeline);
-
-    CurrentGPUContext->DrawIndexed(compiledGeometry->indexBuffer.Data.Count() / sizeof(uint32));
+    // Large geometry is drawn from its own buffers and clipped by the hardware scissor, only glyphs take the edge parameters from constants
+    RecordedDraw& draw = RecordDraw(GetDrawPipeline(compiledGeometry), compiledGeometry->texture, compiledGeometry->isGlyphs ? compiledGeometry->sdfParams : Float2::Zero);
+    draw.geometry = compiledGeometry;
+    draw.translation = (Float2)translation;
 }
 
 void FlaxRenderInterface::ReleaseCompiledGeometry(Rml::CompiledGeometryHandle geometry)
 {
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureReleaseCompiledGeometry(geometry);
     ReleaseGeometry(geometry);
 }
 
 void FlaxRenderInterface::EnableScissorRegion(bool enable)
 {
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureEnableScissorRegion(enable);
     UseScissor = enable;
 }
 
 void FlaxRenderInterface::SetScissorRegion(int x, int y, int width, int height)
 {
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureSetScissorRegion(x, y, width, height);
     CurrentScissor = Rectangle((float)x, (float)y, (float)width, (float)height);
 }
 
@@ -345,6 +1749,7 @@ bool FlaxRenderInterface::LoadTexture(Rml::TextureHandle& texture_handle, Rml::V
     texture_dimensions.y = (int)textureSize.Y;
 
     texture_handle = RegisterTexture(texture);
+    Stats.LoadedTextures++;
     return true;
 }
 
@@ -359,8 +1764,15 @@ bool FlaxRenderInterface::GenerateTexture(Rml::TextureHandle& texture_handle, co
     }
 #endif
 
+    Stats.LoadedTextures++;
+    if (Headless)
+    {
+        texture_handle = RegisterTexture(nullptr);
+        return true;
+    }
+
     GPUTextureDescription desc = GPUTextureDescription::New2D(source_dimensions.x, source_dimensions.y, PixelFormat::B8G8R8A8_UNorm);
-    GPUTexture*  texture = GPUDevice::Instance->CreateTexture();
+    GPUTexture* texture = GPUDevice::Instance->CreateTexture(TEXT("RmlUi.GeneratedTexture"));
     if (texture->Init(desc))
         return false;
 
@@ -377,6 +1789,9 @@ bool FlaxRenderInterface::GenerateTexture(Rml::TextureHandle& texture_handle, co
 
 void FlaxRenderInterface::ReleaseTexture(Rml::TextureHandle texture_handle)
 {
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureReleaseTexture(texture_handle);
+
     GPUTexture* texture = LoadedTextures.At((int)texture_handle);
     AssetReference<Texture> textureAssetRef;
     if (LoadedTextureAssets.TryGet(texture, textureAssetRef))
@@ -388,6 +1803,9 @@ void FlaxRenderInterface::ReleaseTexture(Rml::TextureHandle texture_handle)
 
 void FlaxRenderInterface::SetTransform(const Rml::Matrix4f* transform_)
 {
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureSetTransform(transform_);
+
     // We assume the library is not built with row-major matrices enabled
     CurrentTransform = transform_ != nullptr ? *(const Matrix*)transform_->data() : Matrix::Identity;
 }
@@ -409,6 +1827,16 @@ void FlaxRenderInterface::Begin(RenderContext* renderContext, GPUContext* gpuCon
     CurrentViewport = viewport;
     CurrentTransform = Matrix::Identity;
     CurrentScissor = viewport.GetBounds();
+    Stats = FlaxRenderStats();
+    HeadlessCommands.Clear();
+    ContextStats.Clear();
+    FrameContexts.Clear();
+    CurrentContextIndex = 0;
+    TimerFrame++;
+    if (!Headless)
+        ReadContextTimers();
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureBeginFrame(viewport);
 
     Matrix view, projection;
     const float halfWidth = viewport.Width * 0.5f;
@@ -420,14 +1848,76 @@ void FlaxRenderInterface::Begin(RenderContext* renderContext, GPUContext* gpuCon
     Matrix::Multiply(view, projection, ViewProjection);
 }
 
+void FlaxRenderInterface::BeginContext(int32 contextIndex, Rml::Context* context)
+{
+    // Contexts rendered in the same frame share the draw stream but not the render state
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureBeginContext(contextIndex);
+    CurrentContextIndex = contextIndex;
+    CurrentContext = context;
+    while (FrameContexts.Count() <= contextIndex)
+        FrameContexts.Add(nullptr);
+    FrameContexts[contextIndex] = context;
+    CurrentTransform = Matrix::Identity;
+    CurrentScissor = CurrentViewport.GetBounds();
+    UseScissor = false;
+}
+
 void FlaxRenderInterface::End()
 {
-    // Flush generated glyphs to GPU
+    // Flush generated glyphs to GPU before the recorded draws are submitted
     FontManager::Flush();
-    ((FlaxFontEngineInterface*)Rml::GetFontEngineInterface())->FlushFontAtlases();
+    ((FlaxFontEngineInterface*)Rml::GetFontEngineInterface())->FlushFontAtlases(CurrentGPUContext);
+
+    FlushRecordedDraws();
+    if (TimerFrame % TRIM_INTERVAL == 0 && (TrimUnusedFrames > 0 || TrimBudget != 0))
+        TrimGeometryCache(TrimUnusedFrames, TrimBudget);
 
     CurrentRenderContext = nullptr;
     CurrentGPUContext = nullptr;
+    CurrentContext = nullptr;
+    if (RmlUiRenderCapture::IsCapturing())
+        RmlUiRenderCapture::CaptureEndFrame();
+}
+
+bool FlaxRenderInterface::Prewarm()
+{
+    // Returns false while the shader is still loading, failures are reported when the pipelines are used
+    if (BasicShader == nullptr || BasicShader->LastLoadFailed())
+        return true;
+    if (!BasicShader->IsLoaded())
+        return false;
+
+    PROFILE_CPU_NAMED("RmlUi.PrewarmPipelines");
+    InitPipelines();
+    InitGlyphQuadBuffers();
+    return true;
+}
+
+const FlaxRenderStats& FlaxRenderInterface::GetStats() const
+{
+    return Stats;
+}
+
+const FlaxRenderStats& FlaxRenderInterface::GetContextStats(int32 contextIndex) const
+{
+    return ::GetContextStats(contextIndex);
+}
+
+float FlaxRenderInterface::GetContextGPUTime(Rml::Context* context) const
+{
+    const ContextTimer* timer = ContextTimers.TryGet(context);
+    return timer != nullptr ? timer->gpuTime : 0.0f;
+}
+
+bool FlaxRenderInterface::IsHeadless() const
+{
+    return Headless;
+}
+
+const Array<FlaxDrawCommand>& FlaxRenderInterface::GetRecordedCommands() const
+{
+    return HeadlessCommands;
 }
 
 Rml::TextureHandle FlaxRenderInterface::GetTextureHandle(GPUTexture* texture)
@@ -454,13 +1944,131 @@ Rml::TextureHandle FlaxRenderInterface::RegisterTexture(GPUTexture* texture, boo
     return handle;
 }
 
+Rml::TextureHandle FlaxRenderInterface::RegisterSdfTexture(GPUTexture* texture, const Float2& sdfParams)
+{
+    Rml::TextureHandle handle = RegisterTexture(texture, true);
+    SdfTextureParams.Add(handle, sdfParams);
+    return handle;
+}
+
+void FlaxRenderInterface::UnregisterTexture(Rml::TextureHandle handle)
+{
+    // The handle stays reserved, so handles held by RmlUi never point to another texture
+    GPUTexture* texture = LoadedTextures.At((int32)handle);
+    if (texture == nullptr)
+        return;
+    FontTextures.Remove(texture);
+    SdfTextureParams.Remove(handle);
+    LoadedTextures[(int32)handle] = nullptr;
+}
+
+bool FlaxRenderInterface::GetTextureInfo(Rml::TextureHandle handle, FlaxTextureInfo& info) const
+{
+    info = FlaxTextureInfo();
+    if ((int32)handle <= 0 || (int32)handle >= LoadedTextures.Count())
+        return false;
+
+    GPUTexture* texture = LoadedTextures[(int32)handle];
+    info.Texture = texture;
+    if (texture != nullptr)
+    {
+        info.Width = texture->Width();
+        info.Height = texture->Height();
+        info.IsFont = FontTextures.Contains(texture);
+    }
+    info.IsSdf = SdfTextureParams.TryGet(handle, info.SdfParams);
+    AssetReference<Texture> textureAsset;
+    if (texture != nullptr && LoadedTextureAssets.TryGet(texture, textureAsset) && textureAsset != nullptr)
+        info.AssetPath = textureAsset->GetPath();
+    return true;
+}
+
+void FlaxRenderInterface::GetMemoryReport(RmlUiMemoryReport& report) const
+{
+    for (int32 i = 1; i < GeometryCache.Count(); i++)
+    {
+        const CompiledGeometry* geometry = GeometryCache[i];
+        if (!geometry->reserved && !geometry->released)
+            continue;
+        AddGeometryMemory(geometry->reserved ? report.Geometry : report.ReleasedGeometry, geometry);
+    }
+
+    for (const Array<byte>& data : StagingPool)
+        report.DrawBuffers.CPUMemory += data.Capacity();
+    const DynamicBuffer* drawBuffers[] = { BatchVertexBuffer, BatchIndexBuffer };
+    for (const DynamicBuffer* buffer : drawBuffers)
+    {
+        if (buffer == nullptr)
+            continue;
+        report.DrawBuffers.Count++;
+        AddBufferMemory(report.DrawBuffers, *buffer);
+    }
+    const GPUBuffer* glyphQuadBuffers[] = { GlyphQuadVertexBuffer, GlyphQuadIndexBuffer };
+    for (const GPUBuffer* buffer : glyphQuadBuffers)
+    {
+        if (buffer == nullptr)
+            continue;
+        report.DrawBuffers.Count++;
+        report.DrawBuffers.GPUMemory += buffer->GetMemoryUsage();
+    }
+
+    for (const GPUTexture* texture : AllocatedTextures)
+    {
+        report.GeneratedTextures.Count++;
+        report.GeneratedTextures.GPUMemory += texture->GetMemoryUsage();
+    }
+    for (const auto& e : LoadedTextureAssets)
+    {
+        report.TextureAssets.Count++;
+        if (e.Key != nullptr)
+            report.TextureAssets.GPUMemory += e.Key->GetMemoryUsage();
+    }
+}
+
+RmlUiMemoryUsage FlaxRenderInterface::GetGeometryMemoryUsage(Rml::Context* context) const
+{
+    RmlUiMemoryUsage usage;
+    for (int32 i = 1; i < GeometryCache.Count(); i++)
+    {
+        const CompiledGeometry* geometry = GeometryCache[i];
+        if (geometry->reserved && geometry->context == context)
+            AddGeometryMemory(usage, geometry);
+    }
+    return usage;
+}
+
+void FlaxRenderInterface::TrimCaches()
+{
+    TrimGeometryCache(0, 0);
+    StagingPool.Clear();
+}
+
 void FlaxRenderInterface::ReleaseResources()
 {
     LoadedTextureAssets.Clear();
     FontTextures.Clear();
+    SdfTextureParams.Clear();
     LoadedTextures.Clear();
     AllocatedTextures.ClearDelete();
     GeometryCache.ClearDelete();
+    FreeGeometrySlots.Clear();
+    ReleasedGeometryFirst = ReleasedGeometryLast = 0;
+    StagingPool.Clear();
+    GeometryHashes.Clear();
+    PatchableGlyphs.Clear();
+    RecordedDraws.Clear();
+    RecordedTransforms.Clear();
+    if (BatchVertexBuffer)
+        BatchVertexBuffer->Dispose();
+    if (BatchIndexBuffer)
+        BatchIndexBuffer->Dispose();
+    SAFE_DELETE_GPU_RESOURCE(GlyphQuadVertexBuffer);
+    SAFE_DELETE_GPU_RESOURCE(GlyphQuadIndexBuffer);
+    for (auto& e : ContextTimers)
+        e.Value.Dispose();
+    ContextTimers.Clear();
+    FrameContexts.Clear();
+    ContextStats.Clear();
 }
 
 #if !USE_RMLUI_6_0
@@ -1,9 +1,20 @@
 ﻿#pragma once
 
+#include "RmlUiMemory.h"
+
 #include <ThirdParty/RmlUi/Core/RenderInterface.h>
+#include <Engine/Core/Collections/Array.h>
+#include <Engine/Core/Math/Rectangle.h>
+#include <Engine/Core/Math/Vector2.h>
 #include <Engine/Core/Math/Viewport.h>
+#include <Engine/Core/Types/String.h>
 #include <Engine/Content/AssetReference.h>
 
+namespace Rml
+{
+    class Context;
+}
+
 struct RenderContext;
 struct CompiledGeometry;
 class Asset;
@@ -11,6 +22,56 @@ class GPUContext;
 class GPUTexture;
 class Texture;
 
+/// <summary>
+/// Counters of the draws submitted and the geometry compiled by FlaxRenderInterface since the last call to Begin.
+/// </summary>
+struct FlaxRenderStats
+{
+    int32 RecordedDraws;
+    int32 DrawCalls;
+    int32 ReorderedDraws;
+    int32 MergedDraws;
+    int32 CulledDraws;
+    int32 SharedGeometries;
+    int32 CompiledGeometries;
+    int32 ReleasedGeometries;
+    int32 LoadedTextures;
+    double CompileTime;
+    int32 Vertices;
+    int32 Indices;
+    int32 TextureBinds;
+    int32 StateChanges;
+};
+
+/// <summary>
+/// Draw call recorded by a headless render interface instead of being submitted to GPU.
+/// </summary>
+struct FlaxDrawCommand
+{
+    int32 Pipeline;
+    int32 VertexCount;
+    int32 IndexCount;
+    int32 InstanceCount;
+    int32 TextureCount;
+    int32 TextureBinds;
+    bool StateChanged;
+    Rectangle Scissor;
+};
+
+/// <summary>
+/// Description of a texture registered to FlaxRenderInterface.
+/// </summary>
+struct FlaxTextureInfo
+{
+    GPUTexture* Texture = nullptr;
+    int32 Width = 0;
+    int32 Height = 0;
+    bool IsFont = false;
+    bool IsSdf = false;
+    Float2 SdfParams = Float2::Zero;
+    String AssetPath;
+};
+
 /// <summary>
 /// The RenderInterface implementation for Flax Engine.
 /// </summary>
@@ -18,7 +79,7 @@ class FlaxRenderInterface : public Rml::RenderInterface
 {
 public:
     // [Rml::RenderInterface]
-    FlaxRenderInterface();
+    FlaxRenderInterface(bool headless = false);
     ~FlaxRenderInterface() override;
 
     void RenderGeometry(Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture, const Rml::Vector2f& translation) override;
@@ -37,14 +98,29 @@ public:
     void SetViewport(int width, int height);
     void InvalidateShaders(Asset* obj = nullptr);
     void Begin(RenderContext* renderContext, GPUContext* context, Viewport viewport);
+    void BeginContext(int32 contextIndex = 0, Rml::Context* context = nullptr);
     void End();
+    bool Prewarm();
+    const FlaxRenderStats& GetStats() const;
+    const FlaxRenderStats& GetContextStats(int32 contextIndex) const;
+    float GetContextGPUTime(Rml::Context* context) const;
+    bool IsHeadless() const;
     void CompileGeometry(CompiledGeometry* compiledGeometry, Rml::Vertex* vertices, int num_vertices, int* indices, int num_indices, Rml::TextureHandle texture_handle);
     void RenderCompiledGeometry(CompiledGeometry* compiledGeometry, const Rml::Vector2f& translation);
     Rml::TextureHandle GetTextureHandle(GPUTexture* texture);
     Rml::TextureHandle RegisterTexture(GPUTexture* texture, bool isFontTexture = false);
+    Rml::TextureHandle RegisterSdfTexture(GPUTexture* texture, const Float2& sdfParams);
+    void UnregisterTexture(Rml::TextureHandle handle);
+    bool GetTextureInfo(Rml::TextureHandle handle, FlaxTextureInfo& info) const;
+    void GetMemoryReport(RmlUiMemoryReport& report) const;
+    RmlUiMemoryUsage GetGeometryMemoryUsage(Rml::Context* context) const;
+    void TrimCaches();
     void ReleaseResources();
 
 #if !USE_RMLUI_6_0
     void AddFontAtlasTextureHandle(Rml::TextureHandle handle, byte* textureData);
 #endif
+
+protected:
+    const Array<FlaxDrawCommand>& GetRecordedCommands() const;
 };
\ No newline at end of file
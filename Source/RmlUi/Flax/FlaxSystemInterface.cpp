@@ -13,6 +13,8 @@
 
 double FlaxSystemInterface::GetElapsedTime()
 {
+    if (useFixedTime)
+        return fixedTime;
     return (double)Time::GetTimeSinceStartup();
 }
 
@@ -77,4 +79,15 @@ void FlaxSystemInterface::GetClipboardText(Rml::String& text)
 {
     StringAnsi clipboardText = Clipboard::GetText().ToStringAnsi();
     text.assign(clipboardText.Get(), clipboardText.Length());
-}
\ No newline at end of file
+}
+
+void FlaxSystemInterface::SetFixedTime(double time)
+{
+    useFixedTime = true;
+    fixedTime = time;
+}
+
+void FlaxSystemInterface::ClearFixedTime()
+{
+    useFixedTime = false;
+}
@@ -14,4 +14,19 @@ public:
     void SetMouseCursor(const Rml::String& cursor_name) override;
     void SetClipboardText(const Rml::String& text) override;
     void GetClipboardText(Rml::String& text) override;
+
+public:
+    /// <summary>
+    /// Replaces the engine time with the specified time, used for stepping animations at a fixed rate.
+    /// </summary>
+    void SetFixedTime(double time);
+
+    /// <summary>
+    /// Returns to the engine time.
+    /// </summary>
+    void ClearFixedTime();
+
+private:
+    bool useFixedTime = false;
+    double fixedTime = 0.0;
 };
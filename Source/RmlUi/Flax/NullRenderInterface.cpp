@@ -0,0 +1,11 @@
+﻿#include "NullRenderInterface.h"
+
+NullRenderInterface::NullRenderInterface()
+    : FlaxRenderInterface(true)
+{
+}
+
+const Array<FlaxDrawCommand>& NullRenderInterface::GetCommands() const
+{
+    return GetRecordedCommands();
+}
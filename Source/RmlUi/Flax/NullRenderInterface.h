@@ -0,0 +1,19 @@
+﻿#pragma once
+
+#include "FlaxRenderInterface.h"
+
+/// <summary>
+/// The RenderInterface implementation for running without GPU. Geometry, textures, clipping and batching behave the same
+/// as in FlaxRenderInterface, but the draw calls are recorded into memory instead of being submitted.
+/// </summary>
+class NullRenderInterface : public FlaxRenderInterface
+{
+public:
+    NullRenderInterface();
+
+public:
+    /// <summary>
+    /// Returns the draw calls recorded since the last call to Begin.
+    /// </summary>
+    const Array<FlaxDrawCommand>& GetCommands() const;
+};
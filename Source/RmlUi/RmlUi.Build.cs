@@ -52,14 +52,16 @@ public class RmlUi : GameModule
         //options.PrivateDefinitions.Add("USE_RMLUI_6_0");
         string libPath = Path.Combine(FolderPath, "..", "ThirdParty", "Platforms", options.Platform.Target.ToString(), "Binaries", "ThirdParty", options.Architecture.ToString());
 
-        AddLibrary(options, Path.Combine(libPath, "RmlCore"));
-        if (options.Configuration != TargetConfiguration.Release)
-            AddLibrary(options, Path.Combine(libPath, "RmlDebugger"));
-
-        // TODO: Check support in other platforms
-        if (options.Platform.Target != TargetPlatform.Windows)
+        // Windows and Linux are supported when the RmlUi binaries are built for the platform, Linux can run headless with the null graphics device
+        if (options.Platform.Target != TargetPlatform.Windows && options.Platform.Target != TargetPlatform.Linux)
             throw new InvalidPlatformException(options.Platform.Target);
         if (options.Architecture != TargetArchitecture.x64)
             throw new InvalidArchitectureException(options.Architecture);
+        if (!Directory.Exists(libPath))
+            throw new InvalidPlatformException(options.Platform.Target, $"Missing RmlUi binaries for {options.Architecture} in {libPath}");
+
+        AddLibrary(options, Path.Combine(libPath, "RmlCore"));
+        if (options.Configuration != TargetConfiguration.Release)
+            AddLibrary(options, Path.Combine(libPath, "RmlDebugger"));
     }
 }
\ No newline at end of file
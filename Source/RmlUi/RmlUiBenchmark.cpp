@@ -0,0 +1,362 @@
+﻿#include "RmlUiBenchmark.h"
+#include "RmlUiPlugin.h"
+
+// Conflicts with both Flax and RmlUi Math.h
+#undef RadiansToDegrees
+#undef DegreesToRadians
+#undef NormaliseAngle
+
+#include "Flax/FlaxFontEngineInterface.h"
+#include "Flax/FlaxRenderInterface.h"
+#include "Flax/FlaxSystemInterface.h"
+
+#include <ThirdParty/RmlUi/Core/Context.h>
+#include <ThirdParty/RmlUi/Core/Core.h>
+#include <ThirdParty/RmlUi/Core/DataModelHandle.h>
+#include <ThirdParty/RmlUi/Core/ElementDocument.h>
+#include <ThirdParty/RmlUi/Core/TypeConverter.h>
+
+#include <Engine/Core/Log.h>
+#include <Engine/Platform/File.h>
+#include <Engine/Profiler/Profiler.h>
+#include <Engine/Scripting/Enums.h>
+#include <Engine/Serialization/JsonWriters.h>
+
+#include <locale>
+
+// Animations and transitions are stepped with a fixed frame time so the measured frames are the same in every run
+#define BENCHMARK_FRAME_TIME (1.0 / 60.0)
+
+// Number of bound cells in each row of the data grid
+#define BENCHMARK_GRID_COLUMNS 8
+
+#define BENCHMARK_CONTEXT_NAME "RmlUiBenchmark"
+#define BENCHMARK_GRID_MODEL "benchmark_grid"
+
+namespace
+{
+    Rml::Vector<Rml::Vector<int>> GridRows;
+    Rml::DataModelHandle GridModel;
+}
+
+const char* BenchmarkStyle = R"(
+<rml>
+<head>
+<style>
+body { width: 100%; height: 100%; font-family: rmlui-benchmark; font-size: 16px; color: #ffffff; }
+div, p { display: block; }
+.list { height: 100%; overflow: auto; }
+.row { height: 24px; border-bottom: 1px #404040; }
+.row span { display: inline-block; width: 240px; }
+.nest { padding: 1px; border: 1px #808080; }
+p { margin: 4px; }
+.image { display: inline-block; width: 32px; height: 32px; margin: 2px; }
+.gradient { decorator: gradient(vertical #ff8000 #0080ff); }
+.box { display: inline-block; width: 24px; height: 24px; margin: 2px; background-color: #ff0000; transition: transform background-color 0.5s cubic-in-out; }
+.box.active { transform: rotate(90deg) scale(0.5); background-color: #0000ff; }
+.cell { display: inline-block; width: 80px; }
+.label { height: 20px; margin-bottom: 2px; background-color: #303030; }
+</style>
+</head>
+<body>
+)";
+
+const char* BenchmarkText = "The quick brown fox jumps over the lazy dog while the five boxing wizards jump quickly, "
+                            "pack my box with five dozen liquor jugs and sphinx of black quartz, judge my vow. ";
+
+Rml::String GenerateDocument(RmlUiBenchmarkScenario scenario, int32 size, const Rml::String& imageSource)
+{
+    Rml::String rml = BenchmarkStyle;
+    switch (scenario)
+    {
+    case RmlUiBenchmarkScenario::List:
+        rml += "<div class=\"list\">";
+        for (int32 i = 0; i < size; i++)
+            rml += "<div class=\"row\"><span>Item " + Rml::ToString(i) + "</span><span>Value " + Rml::ToString(i * 7) + "</span></div>";
+        rml += "</div>";
+        break;
+    case RmlUiBenchmarkScenario::Nesting:
+        for (int32 i = 0; i < size; i++)
+            rml += "<div class=\"nest\">";
+        rml += "Leaf";
+        for (int32 i = 0; i < size; i++)
+            rml += "</div>";
+        break;
+    case RmlUiBenchmarkScenario::Text:
+        for (int32 i = 0; i < size; i++)
+            rml += "<p>" + Rml::ToString(i) + ". " + BenchmarkText + BenchmarkText + "</p>";
+        break;
+    case RmlUiBenchmarkScenario::Images:
+        for (int32 i = 0; i < size; i++)
+        {
+            if (imageSource.empty())
+                rml += "<div class=\"image gradient\"/>";
+            else
+                rml += "<img class=\"image\" src=\"" + imageSource + "\"/>";
+        }
+        break;
+    case RmlUiBenchmarkScenario::Transitions:
+        for (int32 i = 0; i < size; i++)
+            rml += "<div class=\"box\"/>";
+        break;
+    case RmlUiBenchmarkScenario::DataGrid:
+        rml += "<div data-model=\"" BENCHMARK_GRID_MODEL "\"><div class=\"row\" data-for=\"row : rows\"><span class=\"cell\" data-for=\"cell : row\">{{cell}}</span></div></div>";
+        break;
+    case RmlUiBenchmarkScenario::LabeledRows:
+        for (int32 i = 0; i < size; i++)
+            rml += "<div class=\"label\">Slot " + Rml::ToString(i) + "</div>";
+        break;
+    }
+    rml += "</body></rml>";
+    return rml;
+}
+
+bool CreateGridModel(Rml::Context* context, int32 size)
+{
+    GridRows.assign(size, Rml::Vector<int>(BENCHMARK_GRID_COLUMNS, 0));
+
+    Rml::DataModelConstructor constructor = context->CreateDataModel(BENCHMARK_GRID_MODEL);
+    if (!constructor)
+        return false;
+    constructor.RegisterArray<Rml::Vector<int>>();
+    constructor.RegisterArray<Rml::Vector<Rml::Vector<int>>>();
+    constructor.Bind("rows", &GridRows);
+    GridModel = constructor.GetModelHandle();
+    return true;
+}
+
+// Changes the document the way the scenario is animated before each frame
+void UpdateScenario(RmlUiBenchmarkScenario scenario, Rml::ElementDocument* document, int32 frame)
+{
+    if (scenario == RmlUiBenchmarkScenario::Transitions && frame % 30 == 0)
+    {
+        Rml::ElementList boxes;
+        document->GetElementsByClassName(boxes, "box");
+        const bool active = frame % 60 == 0;
+        for (Rml::Element* box : boxes)
+            box->SetClass("active", active);
+    }
+    else if (scenario == RmlUiBenchmarkScenario::DataGrid)
+    {
+        for (Rml::Vector<int>& row : GridRows)
+            row[frame % BENCHMARK_GRID_COLUMNS]++;
+        GridModel.DirtyVariable("rows");
+    }
+}
+
+void MeasureDocument(Rml::Context* context, Rml::ElementDocument* document, RmlUiBenchmarkScenario scenario, bool synthetic, const RmlUiBenchmarkOptions& options, uint64 startMemory, RmlUiBenchmarkResult& result)
+{
+    auto systemInterface = (FlaxSystemInterface*)Rml::GetSystemInterface();
+    auto renderInterface = (FlaxRenderInterface*)Rml::GetRenderInterface();
+    auto fontEngineInterface = (FlaxFontEngineInterface*)Rml::GetFontEngineInterface();
+    const Viewport viewport(0, 0, options.ViewportSize.X, options.ViewportSize.Y);
+
+    // The fixed time continues from the current time so animations never see it going backwards, the scenario restarts for each run
+    document->Show();
+    const int32 frames = Math::Max(options.Frames, 1);
+    const int32 warmupFrames = Math::Max(options.WarmupFrames, 0);
+    const double startTime = systemInterface->GetElapsedTime();
+    for (int32 frame = -warmupFrames; frame < frames; frame++)
+    {
+        const int32 runFrame = frame + warmupFrames + 1;
+        systemInterface->SetFixedTime(startTime + runFrame * BENCHMARK_FRAME_TIME);
+        if (synthetic)
+            UpdateScenario(scenario, document, runFrame);
+        fontEngineInterface->ResetStats();
+
+        const double updateStart = Platform::GetTimeSeconds();
+        context->Update();
+        const double renderStart = Platform::GetTimeSeconds();
+        renderInterface->Begin(nullptr, nullptr, viewport);
+        renderInterface->BeginContext(0, context);
+        context->Render();
+        renderInterface->End();
+        const double renderEnd = Platform::GetTimeSeconds();
+        if (frame < 0)
+            continue;
+
+        const FlaxRenderStats& renderStats = renderInterface->GetStats();
+        const FlaxFontEngineStats& fontStats = fontEngineInterface->GetStats();
+        result.UpdateTime += renderStart - updateStart;
+        result.RenderTime += renderEnd - renderStart;
+        result.GenerateStringTime += fontStats.GenerateStringTime;
+        result.CompileGeometryTime += renderStats.CompileTime;
+        result.GeneratedStrings += (float)fontStats.GeneratedStrings;
+        result.CompiledGeometries += (float)renderStats.CompiledGeometries;
+        result.RecordedDraws += (float)renderStats.RecordedDraws;
+        result.DrawCalls += (float)renderStats.DrawCalls;
+        result.Vertices += (float)renderStats.Vertices;
+        result.Indices += (float)renderStats.Indices;
+    }
+    result.MemoryDelta = (int64)Platform::GetProcessMemoryStats().UsedPhysicalMemory - (int64)startMemory;
+
+    // Averages per frame in milliseconds
+    const double timeScale = 1000.0 / frames;
+    result.Frames = frames;
+    result.UpdateTime *= timeScale;
+    result.RenderTime *= timeScale;
+    result.GenerateStringTime *= timeScale;
+    result.CompileGeometryTime *= timeScale;
+    result.GeneratedStrings /= frames;
+    result.CompiledGeometries /= frames;
+    result.RecordedDraws /= frames;
+    result.DrawCalls /= frames;
+    result.Vertices /= frames;
+    result.Indices /= frames;
+}
+
+void RunDocument(Rml::Context* context, const Rml::String& rml, const Rml::String& path, RmlUiBenchmarkScenario scenario, bool synthetic, const RmlUiBenchmarkOptions& options, RmlUiBenchmarkResult& result)
+{
+    PROFILE_CPU_NAMED("RmlUi.Benchmark");
+
+    const uint64 startMemory = Platform::GetProcessMemoryStats().UsedPhysicalMemory;
+    if (synthetic && scenario == RmlUiBenchmarkScenario::DataGrid && !CreateGridModel(context, result.Size))
+    {
+        LOG(Error, "RmlUi: Failed to create the benchmark data model");
+        return;
+    }
+
+    const double loadStart = Platform::GetTimeSeconds();
+    Rml::ElementDocument* document = synthetic ? context->LoadDocumentFromMemory(rml, "[benchmark]") : context->LoadDocument(path);
+    result.LoadTime = (Platform::GetTimeSeconds() - loadStart) * 1000.0;
+    if (document == nullptr)
+        LOG(Error, "RmlUi: Failed to load benchmark document {0}", result.Name);
+    else
+    {
+        MeasureDocument(context, document, scenario, synthetic, options, startMemory, result);
+        context->UnloadDocument(document);
+    }
+
+    // Unloaded documents are released by the next update
+    context->Update();
+    if (synthetic && scenario == RmlUiBenchmarkScenario::DataGrid)
+    {
+        context->RemoveDataModel(BENCHMARK_GRID_MODEL);
+        GridModel = Rml::DataModelHandle();
+        GridRows.clear();
+    }
+}
+
+Array<RmlUiBenchmarkResult> RmlUiBenchmark::Run(const RmlUiBenchmarkOptions& options)
+{
+    Array<RmlUiBenchmarkResult> results;
+    if (!RmlUiPlugin::IsHeadless())
+    {
+        LOG(Warning, "RmlUi: Benchmark requires RmlUi running headless with the null graphics device");
+        return results;
+    }
+
+    Rml::Context* context = Rml::CreateContext(BENCHMARK_CONTEXT_NAME, Rml::Vector2i((int)options.ViewportSize.X, (int)options.ViewportSize.Y));
+    if (context == nullptr)
+    {
+        LOG(Error, "RmlUi: Failed to create the benchmark context");
+        return results;
+    }
+
+    // Unknown font families resolve to the fallback face
+    if (options.Font != nullptr && !options.Font->WaitForLoaded())
+    {
+        StringAnsi fontPath = options.Font->GetPath().ToStringAnsi();
+        Rml::GetFontEngineInterface()->LoadFontFace(Rml::String(fontPath.Get(), fontPath.Length()), true, Rml::Style::FontWeight::Auto);
+    }
+    Rml::String imageSource;
+    if (options.Image != nullptr)
+        imageSource = StringAnsi(options.Image->GetPath()).Get();
+
+    Array<RmlUiBenchmarkScenario> scenarios = options.Scenarios;
+    if (scenarios.IsEmpty())
+    {
+        for (int32 i = 0; i <= (int32)RmlUiBenchmarkScenario::LabeledRows; i++)
+            scenarios.Add((RmlUiBenchmarkScenario)i);
+    }
+
+    // The times of generating text and compiling geometry are measured only with per draw instrumentation
+    const RmlUiInstrumentationLevel oldLevel = RmlUiPlugin::GetInstrumentationLevel();
+    RmlUiPlugin::SetInstrumentationLevel(RmlUiInstrumentationLevel::PerDraw);
+
+    // Fix decimal parsing issues by changing the locale
+    std::locale oldLocale = std::locale::global(std::locale::classic());
+    for (const RmlUiBenchmarkScenario scenario : scenarios)
+    {
+        for (const int32 size : options.Sizes)
+        {
+            RmlUiBenchmarkResult& result = results.AddOne();
+            result.Name = ScriptingEnum::ToString(scenario);
+            result.Size = size;
+            RunDocument(context, GenerateDocument(scenario, size, imageSource), Rml::String(), scenario, true, options, result);
+        }
+    }
+    for (const auto& documentAsset : options.Documents)
+    {
+        if (documentAsset == nullptr || documentAsset->WaitForLoaded())
+            continue;
+
+        RmlUiBenchmarkResult& result = results.AddOne();
+        result.Name = documentAsset->GetPath();
+        RunDocument(context, Rml::String(), Rml::String(StringAnsi(documentAsset->GetPath()).Get()), RmlUiBenchmarkScenario::List, false, options, result);
+    }
+    std::locale::global(oldLocale);
+    RmlUiPlugin::SetInstrumentationLevel(oldLevel);
+
+    ((FlaxSystemInterface*)Rml::GetSystemInterface())->ClearFixedTime();
+    Rml::RemoveContext(BENCHMARK_CONTEXT_NAME);
+
+    for (const RmlUiBenchmarkResult& result : results)
+    {
+        LOG(Info, "RmlUi: Benchmark {0} ({1}): update {2} ms, render {3} ms, {4} draw calls, {5} vertices",
+            result.Name, result.Size, result.UpdateTime, result.RenderTime, result.DrawCalls, result.Vertices);
+    }
+
+    if (options.OutputPath.HasChars() && File::WriteAllText(options.OutputPath, ToJson(results), Encoding::UTF8))
+        LOG(Error, "RmlUi: Failed to write benchmark results to {0}", options.OutputPath);
+    return results;
+}
+
+String RmlUiBenchmark::ToJson(const Array<RmlUiBenchmarkResult>& results)
+{
+    rapidjson_flax::StringBuffer buffer;
+    PrettyJsonWriter writer(buffer);
+    writer.StartObject();
+    writer.JKEY("Version");
+    writer.String(RMLUI_PLUGIN_VERSION.ToString());
+    writer.JKEY("Results");
+    writer.StartArray();
+    for (const RmlUiBenchmarkResult& result : results)
+    {
+        writer.StartObject();
+        writer.JKEY("Name");
+        writer.String(result.Name);
+        writer.JKEY("Size");
+        writer.Int(result.Size);
+        writer.JKEY("Frames");
+        writer.Int(result.Frames);
+        writer.JKEY("LoadTime");
+        writer.Double(result.LoadTime);
+        writer.JKEY("UpdateTime");
+        writer.Double(result.UpdateTime);
+        writer.JKEY("RenderTime");
+        writer.Double(result.RenderTime);
+        writer.JKEY("GenerateStringTime");
+        writer.Double(result.GenerateStringTime);
+        writer.JKEY("CompileGeometryTime");
+        writer.Double(result.CompileGeometryTime);
+        writer.JKEY("MemoryDelta");
+        writer.Int64(result.MemoryDelta);
+        writer.JKEY("GeneratedStrings");
+        writer.Float(result.GeneratedStrings);
+        writer.JKEY("CompiledGeometries");
+        writer.Float(result.CompiledGeometries);
+        writer.JKEY("RecordedDraws");
+        writer.Float(result.RecordedDraws);
+        writer.JKEY("DrawCalls");
+        writer.Float(result.DrawCalls);
+        writer.JKEY("Vertices");
+        writer.Float(result.Vertices);
+        writer.JKEY("Indices");
+        writer.Float(result.Indices);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return String(buffer.GetString(), (int32)buffer.GetSize());
+}
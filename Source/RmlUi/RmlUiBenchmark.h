@@ -0,0 +1,209 @@
+﻿#pragma once
+
+#include "RmlUiDocumentAsset.h"
+
+#include <Engine/Content/AssetReference.h>
+#include <Engine/Content/Assets/Texture.h>
+#include <Engine/Core/Math/Vector2.h>
+#include <Engine/Render2D/FontAsset.h>
+#include <Engine/Scripting/ScriptingType.h>
+
+/// <summary>
+/// The synthetic documents generated by RmlUiBenchmark, each scaled by the benchmark sizes.
+/// </summary>
+API_ENUM() enum class RmlUiBenchmarkScenario
+{
+    /// <summary>
+    /// Scrollable list with a row per size unit.
+    /// </summary>
+    List,
+
+    /// <summary>
+    /// Elements nested as deep as the size.
+    /// </summary>
+    Nesting,
+
+    /// <summary>
+    /// Paragraphs of wrapped text, a paragraph per size unit.
+    /// </summary>
+    Text,
+
+    /// <summary>
+    /// Grid of images, an image per size unit. Gradient decorators are used when no image is set.
+    /// </summary>
+    Images,
+
+    /// <summary>
+    /// Boxes with transitions restarted every half second, a box per size unit.
+    /// </summary>
+    Transitions,
+
+    /// <summary>
+    /// Grid bound to a data model which changes every frame, a row per size unit.
+    /// </summary>
+    DataGrid,
+
+    /// <summary>
+    /// Rows with a background and a short text label, a row per size unit. Measures how text merges into the draw calls of the surrounding geometry.
+    /// </summary>
+    LabeledRows,
+};
+
+/// <summary>
+/// Options for running RmlUiBenchmark.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiBenchmarkOptions
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiBenchmarkOptions);
+
+    /// <summary>
+    /// The synthetic documents to run. All scenarios are run when empty.
+    /// </summary>
+    API_FIELD() Array<RmlUiBenchmarkScenario> Scenarios;
+
+    /// <summary>
+    /// The sizes each synthetic document is generated with.
+    /// </summary>
+    API_FIELD() Array<int32> Sizes = { 10, 100, 1000 };
+
+    /// <summary>
+    /// The project documents to run in addition to the synthetic documents.
+    /// </summary>
+    API_FIELD() Array<AssetReference<RmlUiDocumentAsset>> Documents;
+
+    /// <summary>
+    /// The font used by all documents.
+    /// </summary>
+    API_FIELD() AssetReference<FontAsset> Font;
+
+    /// <summary>
+    /// The texture used by the images scenario.
+    /// </summary>
+    API_FIELD() AssetReference<Texture> Image;
+
+    /// <summary>
+    /// The number of measured frames of each document.
+    /// </summary>
+    API_FIELD() int32 Frames = 60;
+
+    /// <summary>
+    /// The number of frames rendered before the measured frames, to exclude the first layout and the glyph rasterization.
+    /// </summary>
+    API_FIELD() int32 WarmupFrames = 5;
+
+    /// <summary>
+    /// The size of the rendered viewport.
+    /// </summary>
+    API_FIELD() Float2 ViewportSize = Float2(1920, 1080);
+
+    /// <summary>
+    /// The path of the JSON file the results are written to. The results are not written when empty.
+    /// </summary>
+    API_FIELD() String OutputPath;
+};
+
+/// <summary>
+/// Measurements of a single benchmarked document. Times are in milliseconds and, like the counters, averaged per measured frame.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiBenchmarkResult
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiBenchmarkResult);
+
+    /// <summary>
+    /// The name of the scenario or the path of the document.
+    /// </summary>
+    API_FIELD() String Name;
+
+    /// <summary>
+    /// The size the synthetic document was generated with, 0 for project documents.
+    /// </summary>
+    API_FIELD() int32 Size = 0;
+
+    /// <summary>
+    /// The number of measured frames.
+    /// </summary>
+    API_FIELD() int32 Frames = 0;
+
+    /// <summary>
+    /// The time of loading the document.
+    /// </summary>
+    API_FIELD() double LoadTime = 0;
+
+    /// <summary>
+    /// The time of updating the context, including the layout.
+    /// </summary>
+    API_FIELD() double UpdateTime = 0;
+
+    /// <summary>
+    /// The time of rendering the context, including the generated text and the compiled geometry.
+    /// </summary>
+    API_FIELD() double RenderTime = 0;
+
+    /// <summary>
+    /// The time of generating text geometry.
+    /// </summary>
+    API_FIELD() double GenerateStringTime = 0;
+
+    /// <summary>
+    /// The time of compiling geometry.
+    /// </summary>
+    API_FIELD() double CompileGeometryTime = 0;
+
+    /// <summary>
+    /// The growth of the physical memory used by the process from before loading the document to the last measured frame, in bytes.
+    /// </summary>
+    API_FIELD() int64 MemoryDelta = 0;
+
+    /// <summary>
+    /// The number of generated strings.
+    /// </summary>
+    API_FIELD() float GeneratedStrings = 0;
+
+    /// <summary>
+    /// The number of compiled geometries, not counting the geometry shared with identical geometry.
+    /// </summary>
+    API_FIELD() float CompiledGeometries = 0;
+
+    /// <summary>
+    /// The number of draws recorded by RmlUi.
+    /// </summary>
+    API_FIELD() float RecordedDraws = 0;
+
+    /// <summary>
+    /// The number of submitted draw calls.
+    /// </summary>
+    API_FIELD() float DrawCalls = 0;
+
+    /// <summary>
+    /// The number of submitted vertices.
+    /// </summary>
+    API_FIELD() float Vertices = 0;
+
+    /// <summary>
+    /// The number of submitted indices.
+    /// </summary>
+    API_FIELD() float Indices = 0;
+};
+
+/// <summary>
+/// Renders synthetic and project documents headless at increasing sizes and measures the time spent in each phase.
+/// </summary>
+API_CLASS(Static) class RMLUI_API RmlUiBenchmark
+{
+    DECLARE_SCRIPTING_TYPE_NO_SPAWN(RmlUiBenchmark);
+
+public:
+    /// <summary>
+    /// Runs the benchmark with per draw instrumentation. Requires RmlUi running headless with the null graphics device.
+    /// </summary>
+    /// <param name="options">The benchmark options.</param>
+    /// <returns>The results of each document and size.</returns>
+    API_FUNCTION() static Array<RmlUiBenchmarkResult> Run(API_PARAM(Ref) const RmlUiBenchmarkOptions& options);
+
+    /// <summary>
+    /// Serializes the results to JSON for comparing with the results of other runs.
+    /// </summary>
+    /// <param name="results">The benchmark results.</param>
+    /// <returns>The JSON text.</returns>
+    API_FUNCTION() static String ToJson(const Array<RmlUiBenchmarkResult>& results);
+};
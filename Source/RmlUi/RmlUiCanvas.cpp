@@ -9,6 +9,8 @@
 
 #include <ThirdParty/RmlUi/Core/Context.h>
 #include <ThirdParty/RmlUi/Core/Core.h>
+#include <ThirdParty/RmlUi/Core/DataModelHandle.h>
+#include <ThirdParty/RmlUi/Core/ElementDocument.h>
 #include <ThirdParty/RmlUi/Core/FontEngineInterface.h>
 #if USE_EDITOR
 #include <ThirdParty/RmlUi/Debugger.h>
@@ -16,6 +18,34 @@
 #include <Engine/Engine/Screen.h>
 #include <Engine/Profiler/ProfilerCPU.h>
 
+#define FRAME_STATS_MODEL "rmlui_frame_stats"
+
+// Overlay document listing the frame statistics of the canvas in the top right corner
+const char* FrameStatsOverlay = R"(
+<rml>
+<head>
+<style>
+body { position: absolute; top: 8px; right: 8px; width: 240px; padding: 6px; background-color: #000000c0; color: #ffffff; font-size: 13px; pointer-events: none; z-index: 1000; }
+div { display: block; }
+span { display: inline-block; width: 150px; }
+</style>
+</head>
+<body data-model=")" FRAME_STATS_MODEL R"(">
+<div><span>Update</span>{{ update_time | format(2) }} ms</div>
+<div><span>Render</span>{{ render_time | format(2) }} ms</div>
+<div><span>GPU</span>{{ gpu_time | format(2) }} ms</div>
+<div><span>Draw calls</span>{{ draw_calls }}</div>
+<div><span>State changes</span>{{ state_changes }}</div>
+<div><span>Vertices</span>{{ vertices }}</div>
+<div><span>Indices</span>{{ indices }}</div>
+<div><span>Compiled geometries</span>{{ compiled_geometries }}</div>
+<div><span>Released geometries</span>{{ released_geometries }}</div>
+<div><span>Loaded textures</span>{{ loaded_textures }}</div>
+<div><span>Rasterized glyphs</span>{{ rasterized_glyphs }}</div>
+</body>
+</rml>
+)";
+
 RmlUiCanvas::RmlUiCanvas(const SpawnParams& params)
     : Actor(params)
 {
@@ -31,6 +61,89 @@ bool RmlUiCanvas::HasFocus() const
     return RmlUiPlugin::GetFocusedCanvas() == this;
 }
 
+RmlUiCanvasFrameStats RmlUiCanvas::GetFrameStats() const
+{
+    return frameStats;
+}
+
+// Copies the statistic shown by the overlay, the variable is dirtied only when the value changes
+template<typename T>
+void UpdateStatsVariable(Rml::DataModelHandle& model, const char* name, T& shown, T value)
+{
+    if (shown == value)
+        return;
+    shown = value;
+    model.DirtyVariable(name);
+}
+
+void RmlUiCanvas::UpdateStatsOverlay()
+{
+    if (context == nullptr)
+        return;
+
+    if (!ShowFrameStats)
+    {
+        if (statsContext != nullptr)
+        {
+            Rml::RemoveContext(statsContext->GetName());
+            statsContext = nullptr;
+        }
+        return;
+    }
+
+    if (statsContext == nullptr)
+    {
+        // The overlay is hosted in its own context rendered after the canvases, its draws and geometry are not counted in the statistics of the canvas
+        const Rml::String name = context->GetName() + "_frame_stats";
+        statsContext = Rml::CreateContext(name, context->GetDimensions());
+        if (statsContext == nullptr)
+            return;
+        statsContext->SetDensityIndependentPixelRatio(context->GetDensityIndependentPixelRatio());
+
+        shownStats = frameStats;
+        Rml::ElementDocument* statsOverlay = nullptr;
+        Rml::DataModelConstructor constructor = statsContext->CreateDataModel(FRAME_STATS_MODEL);
+        if (constructor)
+        {
+            constructor.Bind("update_time", &shownStats.UpdateTime);
+            constructor.Bind("render_time", &shownStats.RenderTime);
+            constructor.Bind("gpu_time", &shownStats.GPUTime);
+            constructor.Bind("draw_calls", &shownStats.DrawCalls);
+            constructor.Bind("state_changes", &shownStats.StateChanges);
+            constructor.Bind("vertices", &shownStats.Vertices);
+            constructor.Bind("indices", &shownStats.Indices);
+            constructor.Bind("compiled_geometries", &shownStats.CompiledGeometries);
+            constructor.Bind("released_geometries", &shownStats.ReleasedGeometries);
+            constructor.Bind("loaded_textures", &shownStats.LoadedTextures);
+            constructor.Bind("rasterized_glyphs", &shownStats.RasterizedGlyphs);
+            statsOverlay = statsContext->LoadDocumentFromMemory(FrameStatsOverlay, "[frame stats]");
+        }
+        if (statsOverlay == nullptr)
+        {
+            Rml::RemoveContext(name);
+            statsContext = nullptr;
+            return;
+        }
+        statsOverlay->Show(Rml::ModalFlag::None, Rml::FocusFlag::None);
+    }
+    else
+    {
+        Rml::DataModelHandle model = statsContext->GetDataModel(FRAME_STATS_MODEL).GetModelHandle();
+        UpdateStatsVariable(model, "update_time", shownStats.UpdateTime, frameStats.UpdateTime);
+        UpdateStatsVariable(model, "render_time", shownStats.RenderTime, frameStats.RenderTime);
+        UpdateStatsVariable(model, "gpu_time", shownStats.GPUTime, frameStats.GPUTime);
+        UpdateStatsVariable(model, "draw_calls", shownStats.DrawCalls, frameStats.DrawCalls);
+        UpdateStatsVariable(model, "state_changes", shownStats.StateChanges, frameStats.StateChanges);
+        UpdateStatsVariable(model, "vertices", shownStats.Vertices, frameStats.Vertices);
+        UpdateStatsVariable(model, "indices", shownStats.Indices, frameStats.Indices);
+        UpdateStatsVariable(model, "compiled_geometries", shownStats.CompiledGeometries, frameStats.CompiledGeometries);
+        UpdateStatsVariable(model, "released_geometries", shownStats.ReleasedGeometries, frameStats.ReleasedGeometries);
+        UpdateStatsVariable(model, "loaded_textures", shownStats.LoadedTextures, frameStats.LoadedTextures);
+        UpdateStatsVariable(model, "rasterized_glyphs", shownStats.RasterizedGlyphs, frameStats.RasterizedGlyphs);
+    }
+    statsContext->Update();
+}
+
 void RmlUiCanvas::BeginPlay(SceneBeginData* data)
 {
     StringAnsi contextName = GetID().ToString().ToStringAnsi();
@@ -71,6 +184,11 @@ void RmlUiCanvas::EndPlay()
         if (EnableDebugger && DebuggerKey != KeyboardKeys::None)
             Rml::Debugger::Shutdown();
 #endif
+        if (statsContext != nullptr)
+        {
+            Rml::RemoveContext(statsContext->GetName());
+            statsContext = nullptr;
+        }
         if (context != nullptr)
         {
             Rml::RemoveContext(context->GetName());
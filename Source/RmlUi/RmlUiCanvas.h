@@ -10,8 +10,72 @@
 namespace Rml
 {
     class Context;
+    class ElementDocument;
 }
 
+/// <summary>
+/// Statistics of the last frame of RmlUiCanvas. Times are in milliseconds.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiCanvasFrameStats
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiCanvasFrameStats);
+
+    /// <summary>
+    /// The CPU time of updating the context, including the layout.
+    /// </summary>
+    API_FIELD() float UpdateTime = 0;
+
+    /// <summary>
+    /// The CPU time of rendering the context, excluding the submission of the draw calls shared with other canvases.
+    /// </summary>
+    API_FIELD() float RenderTime = 0;
+
+    /// <summary>
+    /// The GPU time of the draw calls, measured with timer queries and available a few frames later.
+    /// </summary>
+    API_FIELD() float GPUTime = 0;
+
+    /// <summary>
+    /// The number of submitted draw calls.
+    /// </summary>
+    API_FIELD() int32 DrawCalls = 0;
+
+    /// <summary>
+    /// The number of draw calls which changed the pipeline state, the transform or the scissor.
+    /// </summary>
+    API_FIELD() int32 StateChanges = 0;
+
+    /// <summary>
+    /// The number of submitted vertices.
+    /// </summary>
+    API_FIELD() int32 Vertices = 0;
+
+    /// <summary>
+    /// The number of submitted indices.
+    /// </summary>
+    API_FIELD() int32 Indices = 0;
+
+    /// <summary>
+    /// The number of compiled geometries, not counting the geometry shared with identical geometry.
+    /// </summary>
+    API_FIELD() int32 CompiledGeometries = 0;
+
+    /// <summary>
+    /// The number of released geometries.
+    /// </summary>
+    API_FIELD() int32 ReleasedGeometries = 0;
+
+    /// <summary>
+    /// The number of loaded and generated textures.
+    /// </summary>
+    API_FIELD() int32 LoadedTextures = 0;
+
+    /// <summary>
+    /// The number of distance field and font effect glyphs rasterized.
+    /// </summary>
+    API_FIELD() int32 RasterizedGlyphs = 0;
+};
+
 /// <summary>
 /// The canvas (context) for RmlUi documents.
 /// </summary>
@@ -25,6 +89,9 @@ class RMLUI_API RmlUiCanvas : public Actor
 
 private:
     Rml::Context* context = nullptr;
+    Rml::Context* statsContext = nullptr;
+    RmlUiCanvasFrameStats frameStats;
+    RmlUiCanvasFrameStats shownStats;
 
 public:
     /// <summary>
@@ -32,6 +99,11 @@ public:
     /// </summary>
     API_FIELD() Array<RmlUiFont> Fonts;
 
+    /// <summary>
+    /// The order of rendering the canvas. Canvases with higher order are drawn on top of canvases with lower order.
+    /// </summary>
+    API_FIELD(Attributes="DefaultValue(0)") int32 RenderOrder = 0;
+
     /// <summary>
     /// Turns on the RmlUi debugger plugin for this context when enabled.
     /// </summary>
@@ -41,6 +113,11 @@ public:
     /// The key to toggle visibility of the debugger.
     /// </summary>
     API_FIELD(Attributes="EditorDisplay(\"Debugger\"), DefaultValue(KeyboardKeys.F8), VisibleIf(nameof(EnableDebugger))") KeyboardKeys DebuggerKey = KeyboardKeys::F8;
+
+    /// <summary>
+    /// Shows an overlay with the frame statistics of this canvas.
+    /// </summary>
+    API_FIELD(Attributes="EditorDisplay(\"Debugger\"), DefaultValue(false)") bool ShowFrameStats = false;
 public:
     /// <summary>
     /// The context for hosting RmlUi documents.
@@ -52,6 +129,11 @@ public:
     /// </summary>
     bool HasFocus() const;
 
+    /// <summary>
+    /// Returns the statistics of the last frame of this canvas.
+    /// </summary>
+    API_FUNCTION() RmlUiCanvasFrameStats GetFrameStats() const;
+
 protected:
     // [Actor]
     void BeginPlay(SceneBeginData* data) final override;
@@ -62,6 +144,7 @@ protected:
     void OnTransformChanged() final override;
 
 private:
+    void UpdateStatsOverlay();
     void OnCharInput(Char c) const;
     void OnKeyDown(KeyboardKeys key) const;
     void OnKeyUp(KeyboardKeys key) const;
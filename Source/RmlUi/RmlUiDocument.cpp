@@ -1,6 +1,7 @@
 ﻿#include "RmlUiPlugin.h"
 #include "RmlUiCanvas.h"
 #include "RmlUiDocument.h"
+#include "RmlUiProfiler.h"
 
 // Conflicts with both Flax and RmlUi Math.h
 #undef RadiansToDegrees
@@ -104,6 +105,9 @@ bool RmlUiDocument::LoadDocument()
     if (!GetIsActive())
         return false;
 
+    RMLUI_PROFILE_CPU(PerCanvas, "RmlUi.LoadDocument");
+    RMLUI_PROFILE_DETAIL(Document->GetPath());
+
     // Pre-load font assets
     const auto fontEngineInterface = Rml::GetFontEngineInterface();
     for (const auto& font : Fonts)
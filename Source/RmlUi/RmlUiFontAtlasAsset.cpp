@@ -0,0 +1,238 @@
+﻿#include "RmlUiFontAtlasAsset.h"
+
+#include <Engine/Content/Factories/BinaryAssetFactory.h>
+#include <Engine/Serialization/MemoryReadStream.h>
+#if USE_EDITOR
+#include "RmlUiAsset.h"
+#include "Flax/FlaxFontEngineInterface.h"
+
+#include <Engine/Content/Content.h>
+#include <Engine/ContentImporters/AssetsImportingManager.h>
+#include <Engine/Core/Collections/HashSet.h>
+#include <Engine/Core/Collections/Sorting.h>
+#include <Engine/Core/Log.h>
+#include <Engine/Localization/LocalizedStringTable.h>
+#include <Engine/Serialization/MemoryWriteStream.h>
+#endif
+
+REGISTER_BINARY_ASSET(RmlUiFontAtlasAsset, "RmlUi.RmlUiFontAtlasAsset", true);
+
+RmlUiFontAtlasAsset::RmlUiFontAtlasAsset(const SpawnParams& params, const AssetInfo* info)
+    : BinaryAsset(params, info)
+{
+}
+
+const Array<RmlUiBakedFont>& RmlUiFontAtlasAsset::GetFonts() const
+{
+    return fonts;
+}
+
+uint32 GetRemainingBytes(const MemoryReadStream& stream)
+{
+    return stream.GetLength() - stream.GetPosition();
+}
+
+// Reads the element count of an array, returns true if the elements don't fit in the rest of the stream
+bool ReadCount(MemoryReadStream& stream, int32 elementSize, int32& count)
+{
+    if (GetRemainingBytes(stream) < sizeof(int32))
+        return true;
+    stream.ReadInt32(&count);
+    return count < 0 || (uint64)count * elementSize > GetRemainingBytes(stream);
+}
+
+Asset::LoadResult RmlUiFontAtlasAsset::load()
+{
+    const auto dataChunk = GetChunk(0);
+    if (dataChunk == nullptr)
+        return LoadResult::MissingDataChunk;
+
+    // The counts are validated against the chunk size, a truncated or stale asset fails to load instead of reading out of bounds
+    MemoryReadStream stream(dataChunk->Get(), dataChunk->Data.Length());
+    int32 fontCount;
+    if (ReadCount(stream, sizeof(Guid), fontCount))
+        return LoadResult::InvalidData;
+    fonts.Resize(fontCount);
+    for (RmlUiBakedFont& font : fonts)
+    {
+        int32 count;
+        if (GetRemainingBytes(stream) < sizeof(Guid))
+            return LoadResult::InvalidData;
+        stream.ReadBytes(&font.Font, sizeof(Guid));
+        if (ReadCount(stream, sizeof(int32), count))
+            return LoadResult::InvalidData;
+        font.Sizes.Resize(count);
+        stream.ReadBytes(font.Sizes.Get(), count * sizeof(int32));
+        if (ReadCount(stream, sizeof(Char), count))
+            return LoadResult::InvalidData;
+        font.Charset.ReserveSpace(count);
+        stream.ReadBytes(font.Charset.Get(), count * sizeof(Char));
+        if (GetRemainingBytes(stream) < 2 * sizeof(int32))
+            return LoadResult::InvalidData;
+        stream.ReadInt32(&font.SdfBaseSize);
+        stream.ReadInt32(&font.SdfSpread);
+        if (ReadCount(stream, sizeof(RmlUiBakedGlyph), count))
+            return LoadResult::InvalidData;
+        font.Glyphs.Resize(count);
+        stream.ReadBytes(font.Glyphs.Get(), count * sizeof(RmlUiBakedGlyph));
+        if (ReadCount(stream, 1, count))
+            return LoadResult::InvalidData;
+        font.GlyphData.Resize(count);
+        stream.ReadBytes(font.GlyphData.Get(), count);
+
+        for (const RmlUiBakedGlyph& glyph : font.Glyphs)
+        {
+            if (glyph.DataOffset < 0 || (uint64)glyph.DataOffset + (uint64)glyph.BitmapWidth * glyph.BitmapHeight > (uint64)font.GlyphData.Count())
+                return LoadResult::InvalidData;
+        }
+    }
+
+    return LoadResult::Ok;
+}
+
+void RmlUiFontAtlasAsset::unload(bool isReloading)
+{
+    fonts.Clear();
+}
+
+AssetChunksFlag RmlUiFontAtlasAsset::getChunksToPreload() const
+{
+    return GET_CHUNK_FLAG(0);
+}
+
+#if USE_EDITOR
+
+void AddCharacters(HashSet<Char>& characters, const StringView& text)
+{
+    for (int32 i = 0; i < text.Length(); i++)
+    {
+        if (text[i] >= 32)
+            characters.Add(text[i]);
+    }
+}
+
+void AddDocumentCharacters(HashSet<Char>& characters, const StringView& text)
+{
+    // Skip the markup, only the text content is rendered
+    bool insideTag = false;
+    for (int32 i = 0; i < text.Length(); i++)
+    {
+        const Char c = text[i];
+        if (c == '<')
+            insideTag = true;
+        else if (c == '>')
+            insideTag = false;
+        else if (!insideTag && c >= 32)
+            characters.Add(c);
+    }
+}
+
+void ScanContentCharacters(HashSet<Char>& characters)
+{
+    Array<Guid> assetIds;
+    Content::GetAllAssets(assetIds);
+    for (const Guid& assetId : assetIds)
+    {
+        AssetInfo assetInfo;
+        if (!Content::GetAssetInfo(assetId, assetInfo))
+            continue;
+
+        if (assetInfo.TypeName == TEXT("RmlUi.RmlUiDocumentAsset") || assetInfo.TypeName == TEXT("RmlUi.RmlUiAsset"))
+        {
+            AssetReference<RmlUiAsset> asset = Content::Load<RmlUiAsset>(assetId);
+            if (asset == nullptr || asset->LoadChunks(ALL_ASSET_CHUNKS))
+                continue;
+
+            const FlaxChunk* chunk = asset->GetChunk(0);
+            String text;
+            text.SetUTF8((const char*)chunk->Get(), chunk->Data.Length());
+            AddDocumentCharacters(characters, text);
+        }
+        else if (assetInfo.TypeName == TEXT("FlaxEngine.LocalizedStringTable"))
+        {
+            AssetReference<LocalizedStringTable> table = Content::Load<LocalizedStringTable>(assetId);
+            if (table == nullptr || table->WaitForLoaded())
+                continue;
+
+            for (const auto& entry : table->Entries)
+            {
+                for (const String& value : entry.Value)
+                    AddCharacters(characters, value);
+            }
+        }
+    }
+}
+
+struct BakeContext
+{
+    Array<RmlUiBakedFont> Fonts;
+};
+
+CreateAssetResult CreateRmlUiFontAtlasAsset(CreateAssetContext& context)
+{
+    IMPORT_SETUP(RmlUiFontAtlasAsset, 1);
+
+    auto bakeContext = (BakeContext*)context.CustomArg;
+    MemoryWriteStream stream(4096);
+    stream.WriteInt32(bakeContext->Fonts.Count());
+    for (const RmlUiBakedFont& font : bakeContext->Fonts)
+    {
+        stream.WriteBytes(&font.Font, sizeof(Guid));
+        stream.WriteInt32(font.Sizes.Count());
+        stream.WriteBytes(font.Sizes.Get(), font.Sizes.Count() * sizeof(int32));
+        stream.WriteInt32(font.Charset.Length());
+        stream.WriteBytes(font.Charset.Get(), font.Charset.Length() * sizeof(Char));
+        stream.WriteInt32(font.SdfBaseSize);
+        stream.WriteInt32(font.SdfSpread);
+        stream.WriteInt32(font.Glyphs.Count());
+        stream.WriteBytes(font.Glyphs.Get(), font.Glyphs.Count() * sizeof(RmlUiBakedGlyph));
+        stream.WriteInt32(font.GlyphData.Count());
+        stream.WriteBytes(font.GlyphData.Get(), font.GlyphData.Count());
+    }
+
+    if (context.AllocateChunk(0))
+        return CreateAssetResult::CannotAllocateChunk;
+    context.Data.Header.Chunks[0]->Data.Copy(stream.GetHandle(), stream.GetPosition());
+
+    return CreateAssetResult::Ok;
+}
+
+bool RmlUiFontAtlasAsset::Bake(const RmlUiFontBakeOptions& options, const StringView& outputPath)
+{
+    HashSet<Char> characters;
+    if (options.Charset.HasChars())
+        AddCharacters(characters, options.Charset);
+    else
+    {
+        for (Char c = 32; c < 127; c++)
+            characters.Add(c);
+    }
+    if (options.ScanContent)
+        ScanContentCharacters(characters);
+
+    String charset;
+    charset.ReserveSpace(characters.Count());
+    int32 charIndex = 0;
+    for (const auto& c : characters)
+        charset[charIndex++] = c.Item;
+    Sorting::QuickSort(charset.Get(), charset.Length());
+
+    BakeContext bakeContext;
+    for (const auto& fontAsset : options.Fonts)
+    {
+        if (fontAsset == nullptr || fontAsset->WaitForLoaded())
+            continue;
+
+        RmlUiBakedFont& bakedFont = bakeContext.Fonts.AddOne();
+        bakedFont.Font = fontAsset->GetID();
+        bakedFont.Sizes = options.Sizes;
+        bakedFont.Charset = charset;
+        FlaxFontEngineInterface::BakeSdfGlyphs(fontAsset, charset, bakedFont);
+    }
+
+    LOG(Info, "RmlUi: Baking {0} characters of {1} fonts to {2}", charset.Length(), bakeContext.Fonts.Count(), outputPath);
+    Guid assetId = Guid::Empty;
+    return AssetsImportingManager::Create(CreateRmlUiFontAtlasAsset, outputPath, assetId, &bakeContext);
+}
+
+#endif
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <Engine/Content/AssetReference.h>
+#include <Engine/Content/BinaryAsset.h>
+#include <Engine/Render2D/FontAsset.h>
+
+/// <summary>
+/// Glyph metrics and the location of the baked distance field bitmap.
+/// </summary>
+struct RmlUiBakedGlyph
+{
+    Char Character;
+    int16 AdvanceX;
+    int16 OffsetX;
+    int16 OffsetY;
+    int16 Height;
+    int16 BearingY;
+    uint16 BitmapWidth;
+    uint16 BitmapHeight;
+    int32 DataOffset;
+};
+
+/// <summary>
+/// Baked glyphs of a single font asset.
+/// </summary>
+struct RmlUiBakedFont
+{
+    Guid Font;
+    Array<int32> Sizes;
+    String Charset;
+    int32 SdfBaseSize = 0;
+    int32 SdfSpread = 0;
+    Array<RmlUiBakedGlyph> Glyphs;
+    Array<byte> GlyphData;
+};
+
+#if USE_EDITOR
+/// <summary>
+/// Options for baking font glyphs into RmlUiFontAtlasAsset.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiFontBakeOptions
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiFontBakeOptions);
+
+    /// <summary>
+    /// The fonts to bake.
+    /// </summary>
+    API_FIELD() Array<AssetReference<FontAsset>> Fonts;
+
+    /// <summary>
+    /// The font sizes to prepare when bitmap glyphs are used.
+    /// </summary>
+    API_FIELD() Array<int32> Sizes;
+
+    /// <summary>
+    /// The characters to bake. Printable ASCII characters are used when empty.
+    /// </summary>
+    API_FIELD() String Charset;
+
+    /// <summary>
+    /// Adds all the characters used in RmlUi documents, style sheets and localization tables of the project.
+    /// </summary>
+    API_FIELD() bool ScanContent = true;
+};
+#endif
+
+/// <summary>
+/// RmlUi font atlas asset containing glyphs baked ahead of time. Only the distance field glyphs are baked, the font effect glyphs are generated at runtime.
+/// </summary>
+API_CLASS(NoSpawn) class RMLUI_API RmlUiFontAtlasAsset : public BinaryAsset
+{
+    DECLARE_BINARY_ASSET_HEADER(RmlUiFontAtlasAsset, 1);
+
+private:
+    Array<RmlUiBakedFont> fonts;
+
+public:
+    /// <summary>
+    /// Returns the baked fonts.
+    /// </summary>
+    const Array<RmlUiBakedFont>& GetFonts() const;
+
+#if USE_EDITOR
+    /// <summary>
+    /// Bakes the glyphs of the fonts into a new font atlas asset.
+    /// </summary>
+    /// <param name="options">The bake options.</param>
+    /// <param name="outputPath">The path of the created asset.</param>
+    /// <returns>Returns true if failed, otherwise false.</returns>
+    API_FUNCTION() static bool Bake(const RmlUiFontBakeOptions& options, const StringView& outputPath);
+#endif
+
+protected:
+    // [BinaryAsset]
+    LoadResult load() override;
+    void unload(bool isReloading) override;
+    AssetChunksFlag getChunksToPreload() const override;
+};
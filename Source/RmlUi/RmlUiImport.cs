@@ -40,6 +40,7 @@ public class RmlUiImport
 
         AddOrUpdateProxy(new RmlUiAssetProxy());
         AddOrUpdateProxy(new RmlUiDocumentAssetProxy());
+        AddOrUpdateProxy(new RmlUiFontAtlasAssetProxy());
         Editor.Instance.ContentDatabase.Rebuild(true);
     }
 
@@ -117,6 +118,21 @@ class RmlUiDocumentAssetItem : BinaryAssetItem
     public override SpriteHandle DefaultThumbnail => RmlUiImport.RmlUiAssetIcon;
 }
 
+/// <summary>
+/// RmlUi font atlas asset item.
+/// </summary>
+class RmlUiFontAtlasAssetItem : BinaryAssetItem
+{
+    /// <inheritdoc />
+    public RmlUiFontAtlasAssetItem(string path, ref Guid id, string typeName, Type type)
+    : base(path, ref id, typeName, type, ContentItemSearchFilter.Other)
+    {
+    }
+
+    /// <inheritdoc />
+    public override SpriteHandle DefaultThumbnail => RmlUiImport.RmlUiAssetIcon;
+}
+
 /// <summary>
 /// RmlUi asset proxy object.
 /// </summary>
@@ -195,4 +211,43 @@ public class RmlUiDocumentAssetProxy : RmlUiAssetProxy
     public override string TypeName => "RmlUi.RmlUiDocumentAsset";
 }
 
+/// <summary>
+/// RmlUi font atlas asset proxy object.
+/// </summary>
+public class RmlUiFontAtlasAssetProxy : BinaryAssetProxy
+{
+    /// <inheritdoc />
+    public override string Name => "RmlUi Font Atlas";
+
+    /// <inheritdoc />
+    public override bool IsProxyFor(ContentItem item)
+    {
+        return item is RmlUiFontAtlasAssetItem;
+    }
+
+    /// <inheritdoc />
+    public override string FileExtension => string.Empty;
+
+    /// <inheritdoc/>
+    public override Type AssetType => typeof(RmlUiFontAtlasAsset);
+
+    /// <inheritdoc />
+    public override EditorWindow Open(Editor editor, ContentItem item)
+    {
+        return null;
+    }
+
+    /// <inheritdoc />
+    public override AssetItem ConstructItem(string path, string typeName, ref Guid id)
+    {
+        return new RmlUiFontAtlasAssetItem(path, ref id, typeName, AssetType);
+    }
+
+    /// <inheritdoc />
+    public override Color AccentColor => Color.FromRGB(0xF23A00);
+
+    /// <inheritdoc />
+    public override string TypeName => "RmlUi.RmlUiFontAtlasAsset";
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,276 @@
+﻿#include "RmlUiInputRecorder.h"
+#include "RmlUiCanvas.h"
+#include "RmlUiPlugin.h"
+
+// Conflicts with both Flax and RmlUi Math.h
+#undef RadiansToDegrees
+#undef DegreesToRadians
+#undef NormaliseAngle
+
+#include "Flax/FlaxSystemInterface.h"
+
+#include <ThirdParty/RmlUi/Core/Core.h>
+
+#include <Engine/Core/Collections/Array.h>
+#include <Engine/Core/Log.h>
+#include <Engine/Platform/File.h>
+#include <Engine/Scripting/Scripting.h>
+#include <Engine/Scripting/ScriptingObjectReference.h>
+
+#define RECORDING_MAGIC 0x494C4D52 // RMLI
+#define RECORDING_VERSION 2
+
+enum class InputRecord : byte
+{
+    Frame,
+    Focus,
+    Event,
+};
+
+struct RecordingHeader
+{
+    uint32 magic;
+    uint32 version;
+};
+
+namespace
+{
+    bool Recording = false;
+    String RecordingPath;
+    Array<byte> RecordingData;
+    double RecordingStart = 0.0;
+    Guid RecordedCanvas;
+
+    bool Replaying = false;
+    Array<byte> ReplayData;
+    int32 ReplayPosition = 0;
+    double ReplayStart = 0.0;
+    ScriptingObjectReference<RmlUiCanvas> ReplayCanvas;
+}
+
+Action RmlUiInputRecorder::ReplayCompleted;
+
+template<typename T>
+void WriteRecording(const T& value)
+{
+    RecordingData.Add((const byte*)&value, sizeof(T));
+}
+
+template<typename T>
+bool ReadRecording(T& value)
+{
+    if (ReplayPosition + (int32)sizeof(T) > ReplayData.Count())
+        return false;
+    Platform::MemoryCopy(&value, ReplayData.Get() + ReplayPosition, sizeof(T));
+    ReplayPosition += sizeof(T);
+    return true;
+}
+
+// The event fields are stored separately, so the recording holds no struct padding
+void WriteRecording(const RmlUiInputEvent& inputEvent)
+{
+    WriteRecording(inputEvent.Type);
+    WriteRecording(inputEvent.Value);
+    WriteRecording(inputEvent.Position);
+    WriteRecording(inputEvent.Delta);
+}
+
+bool ReadRecording(RmlUiInputEvent& inputEvent)
+{
+    return ReadRecording(inputEvent.Type) && ReadRecording(inputEvent.Value) && ReadRecording(inputEvent.Position) && ReadRecording(inputEvent.Delta);
+}
+
+FlaxSystemInterface* GetFlaxSystemInterface()
+{
+    return (FlaxSystemInterface*)Rml::GetSystemInterface();
+}
+
+bool RmlUiInputRecorder::StartRecording(const StringView& path)
+{
+    if (!RmlUiPlugin::IsInitialized() || Replaying)
+    {
+        LOG(Warning, "RmlUi: Input recording requires RmlUi to be initialized and not replaying");
+        return true;
+    }
+
+    StopRecording();
+    RecordingPath = path;
+    RecordingData.Clear();
+    RecordingStart = GetFlaxSystemInterface()->GetElapsedTime();
+    RecordedCanvas = Guid::Empty;
+
+    RecordingHeader header;
+    header.magic = RECORDING_MAGIC;
+    header.version = RECORDING_VERSION;
+    WriteRecording(header);
+    Recording = true;
+    return false;
+}
+
+void RmlUiInputRecorder::StopRecording()
+{
+    if (!Recording)
+        return;
+    Recording = false;
+
+    if (File::WriteAllBytes(RecordingPath, RecordingData))
+        LOG(Error, "RmlUi: Failed to write input recording to {0}", RecordingPath);
+    else
+        LOG(Info, "RmlUi: Recorded input to {0}", RecordingPath);
+    RecordingData.Resize(0);
+}
+
+bool RmlUiInputRecorder::IsRecording()
+{
+    return Recording;
+}
+
+bool RmlUiInputRecorder::StartReplay(const StringView& path)
+{
+    if (!RmlUiPlugin::IsInitialized() || Recording)
+    {
+        LOG(Warning, "RmlUi: Input replay requires RmlUi to be initialized and not recording");
+        return true;
+    }
+
+    StopReplay();
+    RecordingHeader header;
+    ReplayPosition = 0;
+    if (File::ReadAllBytes(path, ReplayData) || !ReadRecording(header) || header.magic != RECORDING_MAGIC || header.version != RECORDING_VERSION)
+    {
+        LOG(Error, "RmlUi: Failed to read input recording from {0}", path);
+        ReplayData.Resize(0);
+        return true;
+    }
+
+    ReplayStart = GetFlaxSystemInterface()->GetElapsedTime();
+    ReplayCanvas = RmlUiPlugin::GetFocusedCanvas();
+    Replaying = true;
+    return false;
+}
+
+void RmlUiInputRecorder::StopReplay()
+{
+    if (!Replaying)
+        return;
+    Replaying = false;
+
+    GetFlaxSystemInterface()->ClearFixedTime();
+    ReplayData.Resize(0);
+    ReplayCanvas = nullptr;
+    ReplayCompleted();
+}
+
+bool RmlUiInputRecorder::IsReplaying()
+{
+    return Replaying;
+}
+
+void RmlUiInputRecorder::BeginFrame()
+{
+    if (Recording)
+    {
+        WriteRecording(InputRecord::Frame);
+        WriteRecording(GetFlaxSystemInterface()->GetElapsedTime() - RecordingStart);
+    }
+    if (!Replaying)
+        return;
+
+    // The input recorded before a frame is replayed before the same frame
+    InputRecord record;
+    while (ReadRecording(record))
+    {
+        switch (record)
+        {
+        case InputRecord::Frame:
+        {
+            double time;
+            if (!ReadRecording(time))
+                break;
+            GetFlaxSystemInterface()->SetFixedTime(ReplayStart + time);
+            return;
+        }
+        case InputRecord::Focus:
+        {
+            // The recorded canvas gets the input when it exists, otherwise the input goes to the focused canvas
+            Guid id;
+            if (!ReadRecording(id))
+                break;
+            RmlUiCanvas* canvas = Scripting::FindObject<RmlUiCanvas>(id);
+            ReplayCanvas = canvas != nullptr ? canvas : RmlUiPlugin::GetFocusedCanvas();
+            continue;
+        }
+        case InputRecord::Event:
+        {
+            RmlUiInputEvent inputEvent;
+            if (!ReadRecording(inputEvent))
+                break;
+            if (ReplayCanvas != nullptr)
+                Dispatch(ReplayCanvas.Get(), inputEvent);
+            continue;
+        }
+        default:
+            LOG(Error, "RmlUi: Input recording is corrupted");
+            break;
+        }
+        break;
+    }
+    StopReplay();
+}
+
+void RmlUiInputRecorder::Record(RmlUiCanvas* canvas, const RmlUiInputEvent& inputEvent)
+{
+    if (canvas == nullptr)
+        return;
+
+    if (canvas->GetID() != RecordedCanvas)
+    {
+        RecordedCanvas = canvas->GetID();
+        WriteRecording(InputRecord::Focus);
+        WriteRecording(RecordedCanvas);
+    }
+    WriteRecording(InputRecord::Event);
+    WriteRecording(inputEvent);
+}
+
+void RmlUiInputRecorder::Dispatch(RmlUiCanvas* canvas, const RmlUiInputEvent& inputEvent)
+{
+    switch (inputEvent.Type)
+    {
+    case RmlUiInputEventType::Char:
+        canvas->OnCharInput((Char)inputEvent.Value);
+        break;
+    case RmlUiInputEventType::KeyDown:
+        canvas->OnKeyDown((KeyboardKeys)inputEvent.Value);
+        break;
+    case RmlUiInputEventType::KeyUp:
+        canvas->OnKeyUp((KeyboardKeys)inputEvent.Value);
+        break;
+    case RmlUiInputEventType::MouseDown:
+        canvas->OnMouseDown(inputEvent.Position, (MouseButton)inputEvent.Value);
+        break;
+    case RmlUiInputEventType::MouseUp:
+        canvas->OnMouseUp(inputEvent.Position, (MouseButton)inputEvent.Value);
+        break;
+    case RmlUiInputEventType::MouseWheel:
+        canvas->OnMouseWheel(inputEvent.Position, inputEvent.Delta);
+        break;
+    case RmlUiInputEventType::MouseMove:
+        canvas->OnMouseMove(inputEvent.Position);
+        break;
+    case RmlUiInputEventType::MouseLeave:
+        canvas->OnMouseLeave();
+        break;
+    case RmlUiInputEventType::TouchDown:
+        canvas->OnTouchDown(inputEvent.Position, inputEvent.Value);
+        break;
+    case RmlUiInputEventType::TouchMove:
+        canvas->OnTouchMove(inputEvent.Position, inputEvent.Value);
+        break;
+    case RmlUiInputEventType::TouchUp:
+        canvas->OnTouchUp(inputEvent.Position, inputEvent.Value);
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,102 @@
+﻿#pragma once
+
+#include <Engine/Core/Delegate.h>
+#include <Engine/Core/Math/Vector2.h>
+#include <Engine/Core/Types/StringView.h>
+#include <Engine/Scripting/ScriptingType.h>
+
+class RmlUiCanvas;
+
+/// <summary>
+/// The input forwarded to the focused canvas.
+/// </summary>
+enum class RmlUiInputEventType : byte
+{
+    Char,
+    KeyDown,
+    KeyUp,
+    MouseDown,
+    MouseUp,
+    MouseWheel,
+    MouseMove,
+    MouseLeave,
+    TouchDown,
+    TouchMove,
+    TouchUp,
+};
+
+/// <summary>
+/// Input event forwarded to the focused canvas. The value is the character, key, mouse button or pointer index depending on the type.
+/// </summary>
+struct RmlUiInputEvent
+{
+    RmlUiInputEventType Type;
+    int32 Value;
+    Float2 Position;
+    float Delta;
+};
+
+/// <summary>
+/// Records the input forwarded to the focused canvas with the time of each frame, and replays it with the same time so the replayed frames match the recorded frames.
+/// Running headless the replay gives repeatable scenarios for measuring the performance of the UI.
+/// </summary>
+API_CLASS(Static) class RMLUI_API RmlUiInputRecorder
+{
+    DECLARE_SCRIPTING_TYPE_NO_SPAWN(RmlUiInputRecorder);
+
+public:
+    /// <summary>
+    /// Starts recording the input forwarded to the canvases.
+    /// </summary>
+    /// <param name="path">The path of the written recording file.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() static bool StartRecording(const StringView& path);
+
+    /// <summary>
+    /// Stops recording and writes the recorded input.
+    /// </summary>
+    API_FUNCTION() static void StopRecording();
+
+    /// <summary>
+    /// Returns true while the input is recorded.
+    /// </summary>
+    API_FUNCTION() static bool IsRecording();
+
+    /// <summary>
+    /// Starts replaying the recorded input on the next frames. The RmlUi time follows the recorded frame times and the input from the devices is ignored until the replay is completed.
+    /// </summary>
+    /// <param name="path">The path of the recording file.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() static bool StartReplay(const StringView& path);
+
+    /// <summary>
+    /// Stops replaying and returns to the engine time.
+    /// </summary>
+    API_FUNCTION() static void StopReplay();
+
+    /// <summary>
+    /// Returns true while the recorded input is replayed.
+    /// </summary>
+    API_FUNCTION() static bool IsReplaying();
+
+    /// <summary>
+    /// Occurs when the replay of the recorded input is completed.
+    /// </summary>
+    API_EVENT() static Action ReplayCompleted;
+
+public:
+    /// <summary>
+    /// Starts the next frame, called before the canvases are updated. Records the frame time, or replays the input and the time of the next recorded frame.
+    /// </summary>
+    static void BeginFrame();
+
+    /// <summary>
+    /// Records the input forwarded to the canvas.
+    /// </summary>
+    static void Record(RmlUiCanvas* canvas, const RmlUiInputEvent& inputEvent);
+
+    /// <summary>
+    /// Forwards the input to the canvas.
+    /// </summary>
+    static void Dispatch(RmlUiCanvas* canvas, const RmlUiInputEvent& inputEvent);
+};
@@ -0,0 +1,107 @@
+﻿#pragma once
+
+#include <Engine/Core/Collections/Array.h>
+#include <Engine/Scripting/ScriptingType.h>
+
+class RmlUiCanvas;
+
+/// <summary>
+/// Memory held by a category of RmlUi resources. Sizes are in bytes.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiMemoryUsage
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiMemoryUsage);
+
+    /// <summary>
+    /// The number of resources.
+    /// </summary>
+    API_FIELD() int32 Count = 0;
+
+    /// <summary>
+    /// The GPU memory of the resources.
+    /// </summary>
+    API_FIELD() uint64 GPUMemory = 0;
+
+    /// <summary>
+    /// The CPU memory of the resources, including the copies of the data kept after it was uploaded to GPU.
+    /// </summary>
+    API_FIELD() uint64 CPUMemory = 0;
+
+    void Add(const RmlUiMemoryUsage& other)
+    {
+        Count += other.Count;
+        GPUMemory += other.GPUMemory;
+        CPUMemory += other.CPUMemory;
+    }
+};
+
+/// <summary>
+/// Memory held by the geometry of a single canvas.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiCanvasMemoryUsage
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiCanvasMemoryUsage);
+
+    /// <summary>
+    /// The canvas.
+    /// </summary>
+    API_FIELD() RmlUiCanvas* Canvas = nullptr;
+
+    /// <summary>
+    /// The geometry compiled while rendering the canvas. Geometry shared by multiple canvases is counted for the canvas which compiled it first.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage Geometry;
+};
+
+/// <summary>
+/// Memory held by RmlUi resources, by category and by canvas.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiMemoryReport
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiMemoryReport);
+
+    /// <summary>
+    /// The buffers of the compiled geometry in use.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage Geometry;
+
+    /// <summary>
+    /// The buffers of the released geometry, kept until the slot is reused so identical geometry compiled again can take them back.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage ReleasedGeometry;
+
+    /// <summary>
+    /// The buffers shared by all draws, the frame batch, the instance buffer and the glyph quad, and the pooled staging data of compiling geometry.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage DrawBuffers;
+
+    /// <summary>
+    /// The textures generated from the data provided by RmlUi.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage GeneratedTextures;
+
+    /// <summary>
+    /// The texture assets loaded by the documents. The assets may be shared with the rest of the game.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage TextureAssets;
+
+    /// <summary>
+    /// The glyph atlases of the text, including the distance field atlases, the font atlases shared with the engine and the staging textures of the atlas updates.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage FontAtlases;
+
+    /// <summary>
+    /// The atlases of the font effect glyphs.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage EffectAtlases;
+
+    /// <summary>
+    /// The sum of all categories.
+    /// </summary>
+    API_FIELD() RmlUiMemoryUsage Total;
+
+    /// <summary>
+    /// The geometry of each canvas, the geometry compiled outside of rendering a canvas is not included.
+    /// </summary>
+    API_FIELD() Array<RmlUiCanvasMemoryUsage> Canvases;
+};
@@ -12,13 +12,18 @@
 #include "Flax/FlaxFileInterface.h"
 #include "Flax/FlaxRenderInterface.h"
 #include "Flax/FlaxFontEngineInterface.h"
+#include "Flax/NullRenderInterface.h"
+#include "RmlUiRenderCapture.h"
+#include "RmlUiInputRecorder.h"
 
 #include <ThirdParty/RmlUi/Core/Context.h>
+#include <ThirdParty/RmlUi/Core/Core.h>
 #include <ThirdParty/RmlUi/Core/ElementDocument.h>
 
 #include <Engine/Content/Content.h>
 #include <Engine/Content/JsonAsset.h>
 #include <Engine/Core/Config/GameSettings.h>
+#include <Engine/Core/Log.h>
 #include <Engine/Engine/Engine.h>
 #include <Engine/Graphics/GPUDevice.h>
 #include <Engine/Graphics/RenderTask.h>
@@ -29,6 +34,8 @@
 
 #include <locale>
 
+#define PREWARM_CONTEXT_NAME "RmlUiPrewarm"
+
 namespace
 {
     bool RmlUiInitialized = false;
@@ -38,10 +45,21 @@ namespace
     FlaxRenderInterface* FlaxRenderInterfaceInstance = nullptr;
     FlaxFontEngineInterface* FlaxFontEngineInterfaceInstance = nullptr;
     FlaxFileInterface* FlaxFileInterfaceInstance = nullptr;
+    bool PrewarmActive = false;
+    bool Prewarmed = false;
+    RmlUiPrewarmOptions PrewarmOptions;
+    Array<RmlUiCanvas*> SortedCanvases;
+    int32 MemoryWarningThreshold = 0;
+    double NextMemoryCheckTime = 0.0;
+    bool MemoryWarningLogged = false;
 }
 
+Action RmlUiPlugin::PrewarmCompleted;
+
 IMPLEMENT_GAME_SETTINGS_GETTER(RmlUiSettings, "RmlUi");
 
+RmlUiInstrumentationLevel RmlUiProfileScope::Level = RmlUiInstrumentationLevel::PerCanvas;
+
 PluginDescription GetPluginDescription(bool isEditorPlugin)
 {
     PluginDescription description;
@@ -131,7 +149,13 @@ void RmlUiPlugin::InitializeRmlUi()
 
     // Setup Flax Engine interfaces
     FlaxSystemInterfaceInstance = New<FlaxSystemInterface>();
-    FlaxRenderInterfaceInstance = New<FlaxRenderInterface>();
+    if (GPUDevice::Instance == nullptr || GPUDevice::Instance->GetRendererType() == RendererType::Null)
+    {
+        LOG(Info, "RmlUi: Running headless, draw calls are recorded without GPU");
+        FlaxRenderInterfaceInstance = New<NullRenderInterface>();
+    }
+    else
+        FlaxRenderInterfaceInstance = New<FlaxRenderInterface>();
     FlaxFontEngineInterfaceInstance = New<FlaxFontEngineInterface>();
     FlaxFileInterfaceInstance = New<FlaxFileInterface>();
     Rml::SetSystemInterface(FlaxSystemInterfaceInstance);
@@ -141,7 +165,20 @@ void RmlUiPlugin::InitializeRmlUi()
 
     Rml::Initialise();
 
+    const auto settings = RmlUiSettings::Get();
+    RmlUiProfileScope::Level = settings->Instrumentation;
+    MemoryWarningThreshold = settings->MemoryWarningThreshold;
+    NextMemoryCheckTime = 0.0;
+    MemoryWarningLogged = false;
+    if (settings->TraceFrames > 0)
+        RmlUiTrace::Start(settings->TraceFrames, settings->TraceFrameBudget);
+    for (const auto& fontAtlas : settings->BakedFontAtlases)
+        FlaxFontEngineInterfaceInstance->LoadBakedFontAtlas(fontAtlas);
+
     RegisterEvents();
+
+    if (settings->PrewarmOnInitialize)
+        Prewarm(settings->PrewarmOptions);
 }
 
 void RmlUiPlugin::DeinitializeRmlUi()
@@ -152,12 +189,21 @@ void RmlUiPlugin::DeinitializeRmlUi()
     RmlUiInitialized = false;
 
     UnregisterEvents();
+    RmlUiInputRecorder::StopRecording();
+    RmlUiInputRecorder::StopReplay();
+    if (PrewarmActive)
+        Engine::Update.Unbind(&RmlUiPlugin::UpdatePrewarm);
+    PrewarmActive = false;
+    Prewarmed = false;
+    PrewarmOptions = RmlUiPrewarmOptions();
 
     FlaxFontEngineInterfaceInstance->ReleaseFontResources();
 
     Rml::Shutdown();
 
     FlaxRenderInterfaceInstance->ReleaseResources();
+    RmlUiTrace::Stop();
+    RmlUiRenderCapture::StopCapture();
 
     Delete(FlaxSystemInterfaceInstance);
     Delete(FlaxRenderInterfaceInstance);
@@ -167,6 +213,199 @@ void RmlUiPlugin::DeinitializeRmlUi()
     Canvases.Clear();
 }
 
+void RmlUiPlugin::Prewarm(const RmlUiPrewarmOptions& options)
+{
+    if (!RmlUiInitialized)
+    {
+        LOG(Warning, "RmlUi: Prewarm requires RmlUi to be initialized");
+        return;
+    }
+
+    // The asset references start loading the fonts and documents asynchronously
+    PrewarmOptions = options;
+    Prewarmed = false;
+    if (!PrewarmActive)
+    {
+        PrewarmActive = true;
+        Engine::Update.Bind(&RmlUiPlugin::UpdatePrewarm);
+    }
+}
+
+bool RmlUiPlugin::IsPrewarmed()
+{
+    return Prewarmed;
+}
+
+RmlUiInstrumentationLevel RmlUiPlugin::GetInstrumentationLevel()
+{
+    return RmlUiProfileScope::Level;
+}
+
+void RmlUiPlugin::SetInstrumentationLevel(RmlUiInstrumentationLevel level)
+{
+    RmlUiProfileScope::Level = level;
+}
+
+void GetResourceMemory(RmlUiMemoryReport& report)
+{
+    FlaxRenderInterfaceInstance->GetMemoryReport(report);
+    FlaxFontEngineInterfaceInstance->GetMemoryReport(report);
+
+    const RmlUiMemoryUsage* categories[] = { &report.Geometry, &report.ReleasedGeometry, &report.DrawBuffers, &report.GeneratedTextures, &report.TextureAssets, &report.FontAtlases, &report.EffectAtlases };
+    for (const RmlUiMemoryUsage* category : categories)
+        report.Total.Add(*category);
+}
+
+RmlUiMemoryReport RmlUiPlugin::GetMemoryReport()
+{
+    RmlUiMemoryReport report;
+    if (!RmlUiInitialized)
+        return report;
+
+    GetResourceMemory(report);
+    for (RmlUiCanvas* canvas : Canvases)
+    {
+        RmlUiCanvasMemoryUsage& canvasUsage = report.Canvases.AddOne();
+        canvasUsage.Canvas = canvas;
+        canvasUsage.Geometry = FlaxRenderInterfaceInstance->GetGeometryMemoryUsage(canvas->GetContext());
+    }
+    return report;
+}
+
+void RmlUiPlugin::TrimCaches()
+{
+    if (!RmlUiInitialized)
+        return;
+    PROFILE_CPU();
+
+    FlaxRenderInterfaceInstance->TrimCaches();
+    FlaxFontEngineInterfaceInstance->TrimCaches();
+}
+
+float GetMegabytes(const RmlUiMemoryUsage& usage)
+{
+    return (float)(usage.GPUMemory + usage.CPUMemory) / (1024.0f * 1024.0f);
+}
+
+void CheckMemoryUsage()
+{
+    if (MemoryWarningThreshold <= 0)
+        return;
+    const double time = Platform::GetTimeSeconds();
+    if (time < NextMemoryCheckTime)
+        return;
+    NextMemoryCheckTime = time + 1.0;
+
+    // The warning is logged again only after the memory dropped below the threshold
+    RmlUiMemoryReport report;
+    GetResourceMemory(report);
+    const float total = GetMegabytes(report.Total);
+    if (total <= (float)MemoryWarningThreshold)
+    {
+        MemoryWarningLogged = false;
+        return;
+    }
+    if (MemoryWarningLogged)
+        return;
+    MemoryWarningLogged = true;
+    LOG(Warning, "RmlUi: Resources hold {0} MB, over the threshold of {1} MB. Geometry: {2} MB, released geometry: {3} MB, draw buffers: {4} MB, generated textures: {5} MB, texture assets: {6} MB, font atlases: {7} MB, effect atlases: {8} MB",
+        total, MemoryWarningThreshold, GetMegabytes(report.Geometry), GetMegabytes(report.ReleasedGeometry), GetMegabytes(report.DrawBuffers),
+        GetMegabytes(report.GeneratedTextures), GetMegabytes(report.TextureAssets), GetMegabytes(report.FontAtlases), GetMegabytes(report.EffectAtlases));
+}
+
+bool IsAssetPending(Asset* asset)
+{
+    return asset != nullptr && !asset->IsLoaded() && !asset->LastLoadFailed();
+}
+
+// Loads the documents into a hidden context and unloads them after an update, so their style sheets and templates are cached and the text is laid out before a canvas loads them
+void PrewarmDocuments()
+{
+    if (PrewarmOptions.Documents.IsEmpty())
+        return;
+
+    const Float2 screenSize = Screen::GetSize();
+    Rml::Context* context = Rml::CreateContext(PREWARM_CONTEXT_NAME, Rml::Vector2i((int)screenSize.X, (int)screenSize.Y));
+    if (context == nullptr)
+    {
+        LOG(Error, "RmlUi: Failed to create the prewarm context");
+        return;
+    }
+
+    // Fix decimal parsing issues by changing the locale
+    std::locale oldLocale = std::locale::global(std::locale::classic());
+    for (const auto& document : PrewarmOptions.Documents)
+    {
+        if (document == nullptr || !document->IsLoaded())
+            continue;
+
+        PROFILE_CPU_NAMED("RmlUi.PrewarmDocument");
+        Rml::ElementDocument* elementDocument = context->LoadDocument(Rml::String(StringAnsi(document->GetPath()).Get()));
+        if (elementDocument == nullptr)
+        {
+            LOG(Warning, "RmlUi: Failed to prewarm document {0}", document->GetPath());
+            continue;
+        }
+        context->Update();
+        context->UnloadDocument(elementDocument);
+    }
+
+    // Unloaded documents are released by the next update
+    context->Update();
+    std::locale::global(oldLocale);
+    Rml::RemoveContext(PREWARM_CONTEXT_NAME);
+}
+
+void RmlUiPlugin::UpdatePrewarm()
+{
+    PROFILE_CPU_NAMED("RmlUi.Prewarm");
+
+    if (!FlaxRenderInterfaceInstance->Prewarm())
+        return;
+    for (const auto& font : PrewarmOptions.Fonts)
+    {
+        if (IsAssetPending(font))
+            return;
+    }
+    for (const auto& document : PrewarmOptions.Documents)
+    {
+        if (IsAssetPending(document))
+            return;
+    }
+
+    String characters = PrewarmOptions.Characters;
+    if (characters.IsEmpty())
+    {
+        characters.ReserveSpace(127 - 32);
+        for (Char c = 32; c < 127; c++)
+            characters[c - 32] = c;
+    }
+    for (const auto& font : PrewarmOptions.Fonts)
+        FlaxFontEngineInterfaceInstance->PrewarmGlyphs(font, PrewarmOptions.FontSizes, characters);
+    PrewarmDocuments();
+
+    Engine::Update.Unbind(&RmlUiPlugin::UpdatePrewarm);
+    PrewarmActive = false;
+    Prewarmed = true;
+    PrewarmCompleted();
+}
+
+bool RmlUiPlugin::IsHeadless()
+{
+    return FlaxRenderInterfaceInstance != nullptr && FlaxRenderInterfaceInstance->IsHeadless();
+}
+
+void RmlUiPlugin::RenderHeadless(const Float2& size)
+{
+    if (!IsHeadless())
+    {
+        LOG(Warning, "RmlUi: Headless rendering requires the null graphics device");
+        return;
+    }
+
+    RenderCanvases(nullptr, nullptr, Viewport(0, 0, size.X, size.Y));
+}
+
 void RmlUiPlugin::RegisterCanvas(RmlUiCanvas* canvas)
 {
     Canvases.Add(canvas);
@@ -198,7 +437,8 @@ void RmlUiPlugin::DefocusCanvas(RmlUiCanvas* canvas)
 void RmlUiPlugin::RegisterEvents()
 {
     Engine::LateUpdate.Bind(&RmlUiPlugin::Update);
-    MainRenderTask::Instance->PostRender.Bind(&RmlUiPlugin::Render);
+    if (MainRenderTask::Instance != nullptr && !IsHeadless())
+        MainRenderTask::Instance->PostRender.Bind(&RmlUiPlugin::Render);
 
     if (Engine::MainWindow != nullptr)
         RegisterWindowEvents();
@@ -252,7 +492,7 @@ void RmlUiPlugin::RegisterWindowEvents()
 void RmlUiPlugin::UnregisterEvents()
 {
     Engine::LateUpdate.Unbind(&RmlUiPlugin::Update);
-    if (MainRenderTask::Instance != nullptr)
+    if (MainRenderTask::Instance != nullptr && !IsHeadless())
         MainRenderTask::Instance->PostRender.Unbind(&RmlUiPlugin::Render);
 
 #if USE_EDITOR
@@ -292,6 +532,22 @@ void RmlUiPlugin::UnregisterEvents()
     }
 }
 
+void ForwardInput(RmlUiInputEventType type, int32 value = 0, const Float2& position = Float2::Zero, float delta = 0.0f)
+{
+    // The input from the devices would change the outcome of the replayed input
+    if (FocusedCanvas == nullptr || RmlUiInputRecorder::IsReplaying())
+        return;
+
+    RmlUiInputEvent inputEvent;
+    inputEvent.Type = type;
+    inputEvent.Value = value;
+    inputEvent.Position = position;
+    inputEvent.Delta = delta;
+    if (RmlUiInputRecorder::IsRecording())
+        RmlUiInputRecorder::Record(FocusedCanvas, inputEvent);
+    RmlUiInputRecorder::Dispatch(FocusedCanvas, inputEvent);
+}
+
 void RmlUiPlugin::OnCharInput(Char c)
 {
     PROFILE_CPU();
@@ -301,8 +557,7 @@ void RmlUiPlugin::OnCharInput(Char c)
         return;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnCharInput(c);
+    ForwardInput(RmlUiInputEventType::Char, (int32)c);
 }
 
 void RmlUiPlugin::OnKeyDown(KeyboardKeys key)
@@ -314,8 +569,7 @@ void RmlUiPlugin::OnKeyDown(KeyboardKeys key)
         return;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnKeyDown(key);
+    ForwardInput(RmlUiInputEventType::KeyDown, (int32)key);
 }
 
 void RmlUiPlugin::OnKeyUp(KeyboardKeys key)
@@ -327,8 +581,7 @@ void RmlUiPlugin::OnKeyUp(KeyboardKeys key)
         return;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnKeyUp(key);
+    ForwardInput(RmlUiInputEventType::KeyUp, (int32)key);
 }
 
 void RmlUiPlugin::OnMouseDown(const Float2& mousePosition, MouseButton button)
@@ -349,8 +602,7 @@ void RmlUiPlugin::OnMouseDown(const Float2& mousePosition, MouseButton button)
     Float2 realPosition = mousePosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseDown(realPosition, button);
+    ForwardInput(RmlUiInputEventType::MouseDown, (int32)button, realPosition);
 }
 
 void RmlUiPlugin::OnMouseUp(const Float2& mousePosition, MouseButton button)
@@ -371,8 +623,7 @@ void RmlUiPlugin::OnMouseUp(const Float2& mousePosition, MouseButton button)
     Float2 realPosition = mousePosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseUp(realPosition, button);
+    ForwardInput(RmlUiInputEventType::MouseUp, (int32)button, realPosition);
 }
 
 void RmlUiPlugin::OnMouseDoubleClick(const Float2& mousePosition, MouseButton button)
@@ -415,8 +666,7 @@ void RmlUiPlugin::OnMouseWheel(const Float2& mousePosition, float delta)
     Float2 realPosition = mousePosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseWheel(realPosition, -delta);
+    ForwardInput(RmlUiInputEventType::MouseWheel, 0, realPosition, -delta);
 }
 
 void RmlUiPlugin::OnMouseMove(const Float2& mousePosition)
@@ -437,8 +687,7 @@ void RmlUiPlugin::OnMouseMove(const Float2& mousePosition)
     Float2 realPosition = mousePosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseMove(realPosition);
+    ForwardInput(RmlUiInputEventType::MouseMove, 0, realPosition);
 }
 
 void RmlUiPlugin::OnMouseLeave()
@@ -450,8 +699,7 @@ void RmlUiPlugin::OnMouseLeave()
         return;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseLeave();
+    ForwardInput(RmlUiInputEventType::MouseLeave);
 }
 
 void RmlUiPlugin::OnTouchDown(const Float2& pointerPosition, int32 pointerIndex)
@@ -472,8 +720,7 @@ void RmlUiPlugin::OnTouchDown(const Float2& pointerPosition, int32 pointerIndex)
     Float2 realPosition = pointerPosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnTouchDown(realPosition, pointerIndex);
+    ForwardInput(RmlUiInputEventType::TouchDown, pointerIndex, realPosition);
 }
 
 void RmlUiPlugin::OnTouchMove(const Float2& pointerPosition, int32 pointerIndex)
@@ -494,8 +741,7 @@ void RmlUiPlugin::OnTouchMove(const Float2& pointerPosition, int32 pointerIndex)
     Float2 realPosition = pointerPosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnTouchMove(realPosition, pointerIndex);
+    ForwardInput(RmlUiInputEventType::TouchMove, pointerIndex, realPosition);
 }
 
 void RmlUiPlugin::OnTouchUp(const Float2& pointerPosition, int32 pointerIndex)
@@ -516,8 +762,7 @@ void RmlUiPlugin::OnTouchUp(const Float2& pointerPosition, int32 pointerIndex)
     Float2 realPosition = pointerPosition;
 #endif
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnTouchUp(realPosition, pointerIndex);
+    ForwardInput(RmlUiInputEventType::TouchUp, pointerIndex, realPosition);
 }
 
 #if USE_EDITOR
@@ -528,8 +773,7 @@ void RmlUiPlugin::OnCharInputGameWindow(Char c)
     if (!HasEditorGameViewportFocus())
         return;
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnCharInput(c);
+    ForwardInput(RmlUiInputEventType::Char, (int32)c);
 }
 
 void RmlUiPlugin::OnKeyDownGameWindow(KeyboardKeys key)
@@ -539,8 +783,7 @@ void RmlUiPlugin::OnKeyDownGameWindow(KeyboardKeys key)
     if (!HasEditorGameViewportFocus())
         return;
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnKeyDown(key);
+    ForwardInput(RmlUiInputEventType::KeyDown, (int32)key);
 }
 
 void RmlUiPlugin::OnKeyUpGameWindow(KeyboardKeys key)
@@ -550,8 +793,7 @@ void RmlUiPlugin::OnKeyUpGameWindow(KeyboardKeys key)
     if (!HasEditorGameViewportFocus())
         return;
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnKeyUp(key);
+    ForwardInput(RmlUiInputEventType::KeyUp, (int32)key);
 }
 
 void RmlUiPlugin::OnMouseDownGameWindow(const Float2& mousePosition, MouseButton button)
@@ -564,8 +806,7 @@ void RmlUiPlugin::OnMouseDownGameWindow(const Float2& mousePosition, MouseButton
     // FIXME: Offset by the height of the game window title bar
     Float2 realPosition = mousePosition - Float2(0, 25);
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseDown(realPosition, button);
+    ForwardInput(RmlUiInputEventType::MouseDown, (int32)button, realPosition);
 }
 
 void RmlUiPlugin::OnMouseUpGameWindow(const Float2& mousePosition, MouseButton button)
@@ -578,8 +819,7 @@ void RmlUiPlugin::OnMouseUpGameWindow(const Float2& mousePosition, MouseButton b
     // FIXME: Offset by the height of the game window title bar
     Float2 realPosition = mousePosition - Float2(0, 25);
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseUp(realPosition, button);
+    ForwardInput(RmlUiInputEventType::MouseUp, (int32)button, realPosition);
 }
 
 void RmlUiPlugin::OnMouseDoubleClickGameWindow(const Float2& mousePosition, MouseButton button)
@@ -603,8 +843,7 @@ void RmlUiPlugin::OnMouseWheelGameWindow(const Float2& mousePosition, float delt
     if (!HasEditorGameViewportFocus())
         return;
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseWheel(mousePosition, -delta);
+    ForwardInput(RmlUiInputEventType::MouseWheel, 0, mousePosition, -delta);
 }
 
 void RmlUiPlugin::OnMouseMoveGameWindow(const Float2& mousePosition)
@@ -621,8 +860,7 @@ void RmlUiPlugin::OnMouseMoveGameWindow(const Float2& mousePosition)
     // FIXME: Offset by the height of the game window title bar
     Float2 realPosition = mousePosition - Float2(0, 25);
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseMove(realPosition);
+    ForwardInput(RmlUiInputEventType::MouseMove, 0, realPosition);
 }
 
 void RmlUiPlugin::OnMouseLeaveGameWindow()
@@ -632,8 +870,7 @@ void RmlUiPlugin::OnMouseLeaveGameWindow()
     if (!HasEditorGameViewportFocus())
         return;
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnMouseLeave();
+    ForwardInput(RmlUiInputEventType::MouseLeave);
 }
 
 void RmlUiPlugin::OnTouchDownGameWindow(const Float2& pointerPosition, int32 pointerIndex)
@@ -646,8 +883,7 @@ void RmlUiPlugin::OnTouchDownGameWindow(const Float2& pointerPosition, int32 poi
     // FIXME: Offset by the height of the game window title bar
     Float2 realPosition = pointerPosition - Float2(0, 25);
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnTouchDown(realPosition, pointerIndex);
+    ForwardInput(RmlUiInputEventType::TouchDown, pointerIndex, realPosition);
 }
 
 void RmlUiPlugin::OnTouchMoveGameWindow(const Float2& pointerPosition, int32 pointerIndex)
@@ -660,8 +896,7 @@ void RmlUiPlugin::OnTouchMoveGameWindow(const Float2& pointerPosition, int32 poi
     // FIXME: Offset by the height of the game window title bar
     Float2 realPosition = pointerPosition - Float2(0, 25);
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnTouchMove(pointerPosition, pointerIndex);
+    ForwardInput(RmlUiInputEventType::TouchMove, pointerIndex, pointerPosition);
 }
 
 void RmlUiPlugin::OnTouchUpGameWindow(const Float2& pointerPosition, int32 pointerIndex)
@@ -674,42 +909,135 @@ void RmlUiPlugin::OnTouchUpGameWindow(const Float2& pointerPosition, int32 point
     // FIXME: Offset by the height of the game window title bar
     Float2 realPosition = pointerPosition - Float2(0, 25);
 
-    if (FocusedCanvas != nullptr)
-        FocusedCanvas->OnTouchUp(realPosition, pointerIndex);
+    ForwardInput(RmlUiInputEventType::TouchUp, pointerIndex, realPosition);
 }
 #endif
 
+// Adds the resources created and released by a single canvas, taken from the counters before and after its update or render
+void AddResourceStats(RmlUiCanvasFrameStats& frameStats, const FlaxRenderStats& renderStart, const FlaxFontEngineStats& fontStart)
+{
+    const FlaxRenderStats& renderStats = FlaxRenderInterfaceInstance->GetStats();
+    frameStats.CompiledGeometries += renderStats.CompiledGeometries - renderStart.CompiledGeometries;
+    frameStats.ReleasedGeometries += renderStats.ReleasedGeometries - renderStart.ReleasedGeometries;
+    frameStats.LoadedTextures += renderStats.LoadedTextures - renderStart.LoadedTextures;
+    frameStats.RasterizedGlyphs += FlaxFontEngineInterfaceInstance->GetStats().RasterizedGlyphs - fontStart.RasterizedGlyphs;
+}
+
 void RmlUiPlugin::Update()
 {
-    PROFILE_CPU_NAMED("RmlUi.Update");
+    RmlUiTrace::BeginFrame();
+    RMLUI_PROFILE_CPU(PerFrame, "RmlUi.Update");
+    RmlUiInputRecorder::BeginFrame();
 
     // Fix decimal parsing issues by changing the locale
+    const bool timed = RmlUiProfileScope::IsEnabled(RmlUiInstrumentationLevel::PerCanvas);
     std::locale oldLocale = std::locale::global(std::locale::classic());
     for (auto canvas : Canvases)
     {
+        RmlUiTrace::SetCanvas(canvas->GetName());
+        RMLUI_PROFILE_CPU(PerCanvas, "RmlUi.UpdateContext");
+
         auto context = canvas->GetContext();
+        canvas->UpdateStatsOverlay();
+
+        const FlaxRenderStats renderStart = FlaxRenderInterfaceInstance->GetStats();
+        const FlaxFontEngineStats fontStart = FlaxFontEngineInterfaceInstance->GetStats();
+        const double startTime = timed ? Platform::GetTimeSeconds() : 0.0;
         context->Update();
+
+        // The GPU time is measured a few frames later, the rest of the statistics start over every frame
+        const float gpuTime = canvas->frameStats.GPUTime;
+        canvas->frameStats = RmlUiCanvasFrameStats();
+        canvas->frameStats.GPUTime = gpuTime;
+        if (timed)
+            canvas->frameStats.UpdateTime = (float)((Platform::GetTimeSeconds() - startTime) * 1000.0);
+        AddResourceStats(canvas->frameStats, renderStart, fontStart);
     }
     std::locale::global(oldLocale);
+    RmlUiTrace::SetCanvas(StringView::Empty);
+
+    CheckMemoryUsage();
 }
 
 void RmlUiPlugin::Render(GPUContext* gpuContext, RenderContext& renderContext)
 {
-    PROFILE_GPU_CPU_NAMED("RmlUi.Render");
+    RMLUI_PROFILE_GPU_CPU(PerFrame, "RmlUi.Render");
+
+    RenderCanvases(&renderContext, gpuContext, renderContext.Task->GetViewport());
+}
+
+void RmlUiPlugin::RenderCanvases(RenderContext* renderContext, GPUContext* gpuContext, const Viewport& viewport)
+{
+    // Sort the canvases by their order, canvases with the same order keep the order of registration
+    SortedCanvases.Set(Canvases.Get(), Canvases.Count());
+    for (int32 i = 1; i < SortedCanvases.Count(); i++)
+    {
+        RmlUiCanvas* canvas = SortedCanvases[i];
+        int32 j = i;
+        for (; j > 0 && SortedCanvases[j - 1]->RenderOrder > canvas->RenderOrder; j--)
+            SortedCanvases[j] = SortedCanvases[j - 1];
+        SortedCanvases[j] = canvas;
+    }
+
+    // While a render capture is replayed its frames are rendered instead of the canvases
+    if (RmlUiRenderCapture::IsReplaying())
+    {
+        RmlUiRenderCapture::ReplayFrame(renderContext, gpuContext);
+        return;
+    }
+
+    // All canvases are recorded into a single draw stream, submitted and flushed once per frame
+    FlaxRenderInterfaceInstance->Begin(renderContext, gpuContext, viewport);
+    const Rml::Vector2i dimensions((int)viewport.Width, (int)viewport.Height);
 
     // Fix decimal parsing issues by changing the locale
+    const bool timed = RmlUiProfileScope::IsEnabled(RmlUiInstrumentationLevel::PerCanvas);
     std::locale oldLocale = std::locale::global(std::locale::classic());
-    for (auto canvas : Canvases)
+    for (int32 i = 0; i < SortedCanvases.Count(); i++)
     {
-        PROFILE_GPU_CPU_NAMED("RmlUiCanvas");
+        RmlUiCanvas* canvas = SortedCanvases[i];
+        RmlUiTrace::SetCanvas(canvas->GetName());
+        RMLUI_PROFILE_CPU(PerCanvas, "RmlUiCanvas");
 
         Rml::Context* context = canvas->GetContext();
-
-        FlaxRenderInterfaceInstance->Begin(&renderContext, gpuContext, renderContext.Task->GetViewport());
-        Viewport viewport = FlaxRenderInterfaceInstance->GetViewport();
-        context->SetDimensions(Rml::Vector2i((int)viewport.Width, (int)viewport.Height));
+        const FlaxRenderStats renderStart = FlaxRenderInterfaceInstance->GetStats();
+        const FlaxFontEngineStats fontStart = FlaxFontEngineInterfaceInstance->GetStats();
+        const double startTime = timed ? Platform::GetTimeSeconds() : 0.0;
+        if (context->GetDimensions() != dimensions)
+            context->SetDimensions(dimensions);
+        FlaxRenderInterfaceInstance->BeginContext(i, context);
         context->Render();
-        FlaxRenderInterfaceInstance->End();
+        if (timed)
+            canvas->frameStats.RenderTime = (float)((Platform::GetTimeSeconds() - startTime) * 1000.0);
+        AddResourceStats(canvas->frameStats, renderStart, fontStart);
+    }
+
+    // Frame stats overlays are drawn on top of all canvases, after the contexts of the canvases so their statistics don't include the overlays
+    int32 overlayIndex = SortedCanvases.Count();
+    for (RmlUiCanvas* canvas : SortedCanvases)
+    {
+        Rml::Context* statsContext = canvas->statsContext;
+        if (statsContext == nullptr)
+            continue;
+        if (statsContext->GetDimensions() != dimensions)
+            statsContext->SetDimensions(dimensions);
+        FlaxRenderInterfaceInstance->BeginContext(overlayIndex++, statsContext);
+        statsContext->Render();
     }
     std::locale::global(oldLocale);
+    RmlUiTrace::SetCanvas(StringView::Empty);
+
+    FlaxRenderInterfaceInstance->End();
+
+    // Draw calls are submitted together for all canvases, each canvas gets the statistics of its own draws
+    for (int32 i = 0; i < SortedCanvases.Count(); i++)
+    {
+        RmlUiCanvasFrameStats& frameStats = SortedCanvases[i]->frameStats;
+        const FlaxRenderStats& contextStats = FlaxRenderInterfaceInstance->GetContextStats(i);
+        frameStats.DrawCalls = contextStats.DrawCalls;
+        frameStats.StateChanges = contextStats.StateChanges;
+        frameStats.Vertices = contextStats.Vertices;
+        frameStats.Indices = contextStats.Indices;
+        frameStats.GPUTime = timed ? FlaxRenderInterfaceInstance->GetContextGPUTime(SortedCanvases[i]->GetContext()) : 0.0f;
+    }
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 ﻿#pragma once
 
+#include "RmlUiDocumentAsset.h"
+#include "RmlUiFontAtlasAsset.h"
+#include "RmlUiMemory.h"
+#include "RmlUiProfiler.h"
+
 #include <Engine/Core/Config/Settings.h>
+#include <Engine/Core/ISerializable.h>
 #include <Engine/Input/Input.h>
 #include <Engine/Scripting/Plugins/GamePlugin.h>
 #if USE_EDITOR
@@ -16,6 +22,55 @@ class RmlUiCanvas;
 class GPUContext;
 struct RenderContext;
 
+/// <summary>
+/// The rendering mode of text glyphs.
+/// </summary>
+API_ENUM() enum class RmlUiTextRenderMode
+{
+    /// <summary>
+    /// Glyphs are rasterized separately for each font size, font effects are generated on CPU.
+    /// </summary>
+    Bitmap,
+
+    /// <summary>
+    /// Glyphs are stored as signed distance fields shared by all font sizes, font effects are evaluated in shader.
+    /// </summary>
+    SignedDistanceField,
+};
+
+/// <summary>
+/// The resources prepared ahead of time by RmlUiPlugin.Prewarm.
+/// </summary>
+API_STRUCT() struct RmlUiPrewarmOptions : ISerializable
+{
+    API_AUTO_SERIALIZATION();
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiPrewarmOptions);
+
+    ~RmlUiPrewarmOptions() override
+    {
+    }
+
+    /// <summary>
+    /// The fonts to rasterize glyphs for.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(0)") Array<AssetReference<FontAsset>> Fonts;
+
+    /// <summary>
+    /// The font sizes to rasterize glyphs for, used only by bitmap glyphs.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(10)") Array<int32> FontSizes;
+
+    /// <summary>
+    /// The characters to rasterize. Printable ASCII characters are used when empty.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(20)") String Characters;
+
+    /// <summary>
+    /// The documents to load into a hidden context and unload again, so their style sheets and templates are cached before a canvas loads them.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(30)") Array<AssetReference<RmlUiDocumentAsset>> Documents;
+};
+
 /// <summary>
 /// The settings for RmlUi plugin.
 /// </summary>
@@ -24,6 +79,85 @@ API_CLASS() class RmlUiSettings : public SettingsBase
     API_AUTO_SERIALIZATION();
     DECLARE_SCRIPTING_TYPE_NO_SPAWN(RmlUiSettings);
     DECLARE_SETTINGS_GETTER(RmlUiSettings);
+
+public:
+    /// <summary>
+    /// The rendering mode of text glyphs. Signed distance field glyphs use one atlas entry per glyph for all font sizes.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(0), EditorDisplay(\"Text\"), DefaultValue(RmlUiTextRenderMode.Bitmap)")
+    RmlUiTextRenderMode TextRenderMode = RmlUiTextRenderMode::Bitmap;
+
+    /// <summary>
+    /// The font atlases baked ahead of time, loaded when RmlUi is initialized.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(10), EditorDisplay(\"Text\")")
+    Array<AssetReference<RmlUiFontAtlasAsset>> BakedFontAtlases;
+
+    /// <summary>
+    /// Lays out digits with the advance of the widest digit, so changing numbers keep their width and only the changed glyphs are updated.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(20), EditorDisplay(\"Text\"), DefaultValue(false)")
+    bool TabularDigits = false;
+
+    /// <summary>
+    /// The number of textures bound to a single batched draw call. Draws using different textures are merged into one draw call when the value is above one. Devices without support for it use a single texture.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(100), EditorDisplay(\"Rendering\"), Limit(1, 8), DefaultValue(1)")
+    int32 BatchTextureSlots = 1;
+
+    /// <summary>
+    /// Moves draws past the following draws which don't overlap them to group draws with the same texture, so more draws are merged into a single draw call. The visible result is not changed.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(110), EditorDisplay(\"Rendering\"), DefaultValue(false)")
+    bool ReorderDraws = false;
+
+    /// <summary>
+    /// The number of rendered frames after which the buffers of released geometry are freed. Released geometry is kept so identical geometry compiled again can take it back. Never freed when zero.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(120), EditorDisplay(\"Rendering\"), Limit(0), DefaultValue(600)")
+    int32 GeometryCacheUnusedFrames = 600;
+
+    /// <summary>
+    /// The memory in megabytes of the compiled geometry above which the least recently used released geometry is freed. The geometry in use is never freed. Not limited when zero.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(130), EditorDisplay(\"Rendering\"), Limit(0), DefaultValue(64)")
+    int32 GeometryCacheBudget = 64;
+
+    /// <summary>
+    /// Loads the shaders and creates the pipeline states when RmlUi is initialized instead of on the first rendered frame.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(200), EditorDisplay(\"Prewarm\"), DefaultValue(true)")
+    bool PrewarmOnInitialize = true;
+
+    /// <summary>
+    /// The fonts and documents prepared when RmlUi is initialized.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(210), EditorDisplay(\"Prewarm\")")
+    RmlUiPrewarmOptions PrewarmOptions;
+
+    /// <summary>
+    /// The profiler events and timings recorded by RmlUi. The per draw events are only meant for investigating a single frame, their overhead distorts the measured times.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(300), EditorDisplay(\"Profiling\"), DefaultValue(RmlUiInstrumentationLevel.PerCanvas)")
+    RmlUiInstrumentationLevel Instrumentation = RmlUiInstrumentationLevel::PerCanvas;
+
+    /// <summary>
+    /// The number of the last frames kept in the rolling trace of RmlUi events, written in the Chrome trace format. The trace is not recorded when zero.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(310), EditorDisplay(\"Profiling\"), Limit(0, 1000), DefaultValue(0)")
+    int32 TraceFrames = 0;
+
+    /// <summary>
+    /// The RmlUi time of a single frame in milliseconds above which the recorded trace is dumped to the RmlUiTraces directory in the product local folder. Not dumped automatically when zero.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(320), EditorDisplay(\"Profiling\"), Limit(0), DefaultValue(4.0f)")
+    float TraceFrameBudget = 4.0f;
+
+    /// <summary>
+    /// The memory in megabytes held by RmlUi resources above which a warning with the memory report is logged. Checked once per second, not checked when zero.
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(330), EditorDisplay(\"Profiling\"), Limit(0), DefaultValue(0)")
+    int32 MemoryWarningThreshold = 0;
 };
 
 /// <summary>
@@ -62,6 +196,54 @@ public:
     /// </summary>
     static void DeinitializeRmlUi();
 
+    /// <summary>
+    /// Loads the shader, creates the pipeline states and prepares the glyphs and documents in the background over the following frames.
+    /// </summary>
+    /// <param name="options">The fonts and documents to prepare.</param>
+    API_FUNCTION() static void Prewarm(API_PARAM(Ref) const RmlUiPrewarmOptions& options);
+
+    /// <summary>
+    /// Returns true if the last prewarm has completed.
+    /// </summary>
+    API_FUNCTION() static bool IsPrewarmed();
+
+    /// <summary>
+    /// Occurs when the prewarm has completed.
+    /// </summary>
+    API_EVENT() static Action PrewarmCompleted;
+
+    /// <summary>
+    /// Returns true if RmlUi runs without GPU and records the draw calls instead of submitting them.
+    /// </summary>
+    API_FUNCTION() static bool IsHeadless();
+
+    /// <summary>
+    /// Renders all canvases when running headless, the draw calls are recorded in memory.
+    /// </summary>
+    /// <param name="size">The size of the rendered viewport.</param>
+    API_FUNCTION() static void RenderHeadless(const Float2& size);
+
+    /// <summary>
+    /// Gets the current instrumentation level, initialized from the settings.
+    /// </summary>
+    API_FUNCTION() static RmlUiInstrumentationLevel GetInstrumentationLevel();
+
+    /// <summary>
+    /// Sets the instrumentation level, the change applies from the next frame.
+    /// </summary>
+    /// <param name="level">The instrumentation level.</param>
+    API_FUNCTION() static void SetInstrumentationLevel(RmlUiInstrumentationLevel level);
+
+    /// <summary>
+    /// Gets the memory held by RmlUi resources, by category and by canvas.
+    /// </summary>
+    API_FUNCTION() static RmlUiMemoryReport GetMemoryReport();
+
+    /// <summary>
+    /// Frees the buffers of all released geometry and the pooled staging resources, meant to be called on level transitions.
+    /// </summary>
+    API_FUNCTION() static void TrimCaches();
+
     /// <summary>
     /// Register RmlUiCanvas for updates and rendering.
     /// </summary>
@@ -118,7 +300,9 @@ private:
     static void OnTouchUpGameWindow(const Float2& pointerPosition, int32 pointerIndex);
 #endif
     static void Update();
+    static void UpdatePrewarm();
     static void Render(GPUContext* gpuContext, RenderContext& renderContext);
+    static void RenderCanvases(RenderContext* renderContext, GPUContext* gpuContext, const Viewport& viewport);
 };
 
 #if USE_EDITOR
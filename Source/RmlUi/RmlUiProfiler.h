@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include "RmlUiTrace.h"
+
+#include <Engine/Profiler/Profiler.h>
+
+/// <summary>
+/// The amount of profiler events and timings recorded by RmlUi. Higher levels include the events of the lower levels.
+/// </summary>
+API_ENUM() enum class RmlUiInstrumentationLevel
+{
+    /// <summary>
+    /// No profiler events or timings, the frame statistics contain only the counters.
+    /// </summary>
+    Off,
+
+    /// <summary>
+    /// Profiler events of updating and rendering all canvases and of submitting the draw calls.
+    /// </summary>
+    PerFrame,
+
+    /// <summary>
+    /// Profiler events, CPU timings and GPU timer queries of each canvas.
+    /// </summary>
+    PerCanvas,
+
+    /// <summary>
+    /// Profiler events and timings of each draw, compiled geometry and generated string. The overhead of the events is significant with many draws.
+    /// </summary>
+    PerDraw,
+};
+
+/// <summary>
+/// Profiler event which is recorded only when the instrumentation level is at least the level of the event. The events of all levels are recorded to the trace while it is recorded.
+/// </summary>
+struct RmlUiProfileScope
+{
+    /// <summary>
+    /// The current instrumentation level.
+    /// </summary>
+    static RmlUiInstrumentationLevel Level;
+
+    static bool IsEnabled(RmlUiInstrumentationLevel level)
+    {
+        return Level >= level;
+    }
+
+    RmlUiProfileScope(RmlUiInstrumentationLevel level, const Char* name, bool gpu)
+    {
+        traceEvent = RmlUiTrace::IsRecording() ? RmlUiTrace::BeginEvent(name) : -1;
+#if COMPILE_WITH_PROFILER
+        cpuEvent = gpuEvent = -1;
+        if (Level < level)
+            return;
+        cpuEvent = ProfilerCPU::BeginEvent(name);
+        if (gpu)
+            gpuEvent = ProfilerGPU::BeginEvent(name);
+#endif
+    }
+
+    ~RmlUiProfileScope()
+    {
+#if COMPILE_WITH_PROFILER
+        if (gpuEvent != -1)
+            ProfilerGPU::EndEvent(gpuEvent);
+        if (cpuEvent != -1)
+            ProfilerCPU::EndEvent(cpuEvent);
+#endif
+        if (traceEvent != -1)
+            RmlUiTrace::EndEvent(traceEvent);
+    }
+
+    /// <summary>
+    /// Annotates the trace event, e.g. with the name of the loaded document.
+    /// </summary>
+    void SetDetail(const StringView& detail)
+    {
+        if (traceEvent != -1)
+            RmlUiTrace::SetEventDetail(traceEvent, detail);
+    }
+
+    void SetDetail(const StringAnsiView& detail)
+    {
+        if (traceEvent != -1)
+            RmlUiTrace::SetEventDetail(traceEvent, String(detail));
+    }
+
+private:
+    int32 traceEvent;
+#if COMPILE_WITH_PROFILER
+    int32 cpuEvent;
+    int32 gpuEvent;
+#endif
+};
+
+// Profiler events of the given RmlUiInstrumentationLevel
+#define RMLUI_PROFILE_CPU(level, name) RmlUiProfileScope RmlUiProfileBlock(RmlUiInstrumentationLevel::level, TEXT(name), false)
+#define RMLUI_PROFILE_GPU_CPU(level, name) RmlUiProfileScope RmlUiProfileBlock(RmlUiInstrumentationLevel::level, TEXT(name), true)
+#define RMLUI_PROFILE_DETAIL(detail) RmlUiProfileBlock.SetDetail(detail)
@@ -0,0 +1,548 @@
+﻿#include "RmlUiRenderCapture.h"
+#include "RmlUiPlugin.h"
+
+// Conflicts with both Flax and RmlUi Math.h
+#undef RadiansToDegrees
+#undef DegreesToRadians
+#undef NormaliseAngle
+
+#include "Flax/FlaxRenderInterface.h"
+
+#include <ThirdParty/RmlUi/Core/Core.h>
+
+#include <Engine/Core/Collections/Array.h>
+#include <Engine/Core/Collections/Dictionary.h>
+#include <Engine/Core/Collections/HashSet.h>
+#include <Engine/Core/Log.h>
+#include <Engine/Graphics/GPUDevice.h>
+#include <Engine/Graphics/Textures/GPUTexture.h>
+#include <Engine/Platform/File.h>
+#include <Engine/Profiler/Profiler.h>
+
+#define CAPTURE_MAGIC 0x434C4D52 // RMLC
+#define CAPTURE_VERSION 1
+
+enum class CaptureCommand : byte
+{
+    BeginFrame,
+    BeginContext,
+    EndFrame,
+    RenderGeometry,
+    CompileGeometry,
+    RenderCompiledGeometry,
+    ReleaseCompiledGeometry,
+    EnableScissorRegion,
+    SetScissorRegion,
+    SetTransform,
+    DefineTexture,
+    ReleaseTexture,
+};
+
+struct CaptureHeader
+{
+    uint32 magic;
+    uint32 version;
+    int32 frames;
+};
+
+struct CaptureReader
+{
+    const byte* data;
+    int32 size;
+    int32 position;
+
+    bool Read(void* output, int32 count)
+    {
+        if (count < 0 || position + count > size)
+            return false;
+        Platform::MemoryCopy(output, data + position, count);
+        position += count;
+        return true;
+    }
+
+    template<typename T>
+    T Read()
+    {
+        T value = T();
+        if (!Read(&value, sizeof(T)))
+            position = size + 1;
+        return value;
+    }
+
+    bool IsValid() const
+    {
+        return position <= size;
+    }
+};
+
+namespace
+{
+    bool Capturing = false;
+    String CapturePath;
+    int32 CaptureFrames = 0;
+    int32 CapturedFrames = 0;
+    Array<byte> CaptureData;
+    HashSet<Rml::TextureHandle> CapturedTextures;
+
+    bool Replaying = false;
+    Array<byte> ReplayData;
+    CaptureReader ReplayReader;
+    int32 ReplayIterations = 0;
+    Dictionary<uint64, Rml::CompiledGeometryHandle> ReplayGeometries;
+    Dictionary<uint64, Rml::TextureHandle> ReplayTextures;
+    Dictionary<uint64, Rml::TextureHandle> ReplayTextureHandles;
+    Array<Rml::CompiledGeometryHandle> ReplayCompiledGeometries;
+    Array<GPUTexture*> ReplayAllocatedTextures;
+    Array<Rml::Vertex> ReplayVertices;
+    Array<int> ReplayIndices;
+    RmlUiCaptureReplayResult ReplayResult;
+}
+
+Delegate<const RmlUiCaptureReplayResult&> RmlUiRenderCapture::ReplayCompleted;
+
+template<typename T>
+void WriteCapture(const T& value)
+{
+    CaptureData.Add((const byte*)&value, sizeof(T));
+}
+
+void WriteCapture(CaptureCommand command)
+{
+    CaptureData.Add((byte)command);
+}
+
+void WriteGeometry(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture)
+{
+    WriteCapture((uint64)texture);
+    WriteCapture((int32)num_vertices);
+    WriteCapture((int32)num_indices);
+    CaptureData.Add((const byte*)vertices, num_vertices * (int32)sizeof(Rml::Vertex));
+    CaptureData.Add((const byte*)indices, num_indices * (int32)sizeof(int));
+}
+
+FlaxRenderInterface* GetFlaxRenderInterface()
+{
+    return (FlaxRenderInterface*)Rml::GetRenderInterface();
+}
+
+bool RmlUiRenderCapture::StartCapture(const StringView& path, int32 frames)
+{
+    if (!RmlUiPlugin::IsInitialized() || Replaying || frames <= 0)
+    {
+        LOG(Warning, "RmlUi: Render capture requires RmlUi to be initialized and not replaying");
+        return true;
+    }
+
+    StopCapture();
+    CapturePath = path;
+    CaptureFrames = frames;
+    CapturedFrames = 0;
+    CaptureData.Clear();
+    CapturedTextures.Clear();
+
+    // Geometry compiled earlier is compiled again when rendered, so the capture contains the vertices of all rendered geometry
+    Rml::ReleaseCompiledGeometry();
+    Capturing = true;
+    return false;
+}
+
+void RmlUiRenderCapture::StopCapture()
+{
+    if (!Capturing)
+        return;
+    Capturing = false;
+
+    CaptureHeader header;
+    header.magic = CAPTURE_MAGIC;
+    header.version = CAPTURE_VERSION;
+    header.frames = CapturedFrames;
+    Array<byte> fileData;
+    fileData.Add((const byte*)&header, sizeof(header));
+    fileData.Add(CaptureData);
+    if (File::WriteAllBytes(CapturePath, fileData))
+        LOG(Error, "RmlUi: Failed to write render capture to {0}", CapturePath);
+    else
+        LOG(Info, "RmlUi: Captured {0} frames to {1} ({2} kB)", CapturedFrames, CapturePath, fileData.Count() / 1024);
+
+    CaptureData.Resize(0);
+    CapturedTextures.Clear();
+}
+
+bool RmlUiRenderCapture::IsCapturing()
+{
+    return Capturing;
+}
+
+void RmlUiRenderCapture::CaptureBeginFrame(const Viewport& viewport)
+{
+    WriteCapture(CaptureCommand::BeginFrame);
+    WriteCapture(viewport.Width);
+    WriteCapture(viewport.Height);
+}
+
+void RmlUiRenderCapture::CaptureBeginContext(int32 contextIndex)
+{
+    WriteCapture(CaptureCommand::BeginContext);
+    WriteCapture(contextIndex);
+}
+
+void RmlUiRenderCapture::CaptureEndFrame()
+{
+    WriteCapture(CaptureCommand::EndFrame);
+    if (++CapturedFrames >= CaptureFrames)
+        StopCapture();
+}
+
+void RmlUiRenderCapture::CaptureRenderGeometry(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture, const Rml::Vector2f& translation)
+{
+    CaptureTexture(texture);
+    WriteCapture(CaptureCommand::RenderGeometry);
+    WriteCapture(translation);
+    WriteGeometry(vertices, num_vertices, indices, num_indices, texture);
+}
+
+void RmlUiRenderCapture::CaptureCompileGeometry(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture, Rml::CompiledGeometryHandle geometry)
+{
+    CaptureTexture(texture);
+    WriteCapture(CaptureCommand::CompileGeometry);
+    WriteCapture((uint64)geometry);
+    WriteGeometry(vertices, num_vertices, indices, num_indices, texture);
+}
+
+void RmlUiRenderCapture::CaptureRenderCompiledGeometry(Rml::CompiledGeometryHandle geometry, const Rml::Vector2f& translation)
+{
+    WriteCapture(CaptureCommand::RenderCompiledGeometry);
+    WriteCapture((uint64)geometry);
+    WriteCapture(translation);
+}
+
+void RmlUiRenderCapture::CaptureReleaseCompiledGeometry(Rml::CompiledGeometryHandle geometry)
+{
+    WriteCapture(CaptureCommand::ReleaseCompiledGeometry);
+    WriteCapture((uint64)geometry);
+}
+
+void RmlUiRenderCapture::CaptureEnableScissorRegion(bool enable)
+{
+    WriteCapture(CaptureCommand::EnableScissorRegion);
+    WriteCapture(enable);
+}
+
+void RmlUiRenderCapture::CaptureSetScissorRegion(int x, int y, int width, int height)
+{
+    WriteCapture(CaptureCommand::SetScissorRegion);
+    WriteCapture((int32)x);
+    WriteCapture((int32)y);
+    WriteCapture((int32)width);
+    WriteCapture((int32)height);
+}
+
+void RmlUiRenderCapture::CaptureSetTransform(const Rml::Matrix4f* transform)
+{
+    WriteCapture(CaptureCommand::SetTransform);
+    WriteCapture(transform != nullptr);
+    if (transform != nullptr)
+        CaptureData.Add((const byte*)transform->data(), 16 * sizeof(float));
+}
+
+void RmlUiRenderCapture::CaptureTexture(Rml::TextureHandle texture)
+{
+    // Textures are defined before their first use, the textures created before the capture included
+    if (texture == 0 || CapturedTextures.Contains(texture))
+        return;
+    CapturedTextures.Add(texture);
+
+    FlaxTextureInfo info;
+    GetFlaxRenderInterface()->GetTextureInfo(texture, info);
+    WriteCapture(CaptureCommand::DefineTexture);
+    WriteCapture((uint64)texture);
+    WriteCapture(info.Width);
+    WriteCapture(info.Height);
+    WriteCapture(info.IsFont);
+    WriteCapture(info.IsSdf);
+    WriteCapture(info.SdfParams);
+}
+
+void RmlUiRenderCapture::CaptureReleaseTexture(Rml::TextureHandle texture)
+{
+    if (!CapturedTextures.Contains(texture))
+        return;
+    CapturedTextures.Remove(texture);
+    WriteCapture(CaptureCommand::ReleaseTexture);
+    WriteCapture((uint64)texture);
+}
+
+Rml::TextureHandle ReplayTexture(uint64 texture)
+{
+    Rml::TextureHandle handle = 0;
+    ReplayTextures.TryGet(texture, handle);
+    return handle;
+}
+
+void DefineReplayTexture(FlaxRenderInterface* renderInterface, uint64 texture, int32 width, int32 height, bool isFont, bool isSdf, const Float2& sdfParams)
+{
+    // Textures are created once per replay, the following iterations reuse their handles
+    Rml::TextureHandle handle;
+    if (ReplayTextureHandles.TryGet(texture, handle))
+    {
+        ReplayTextures[texture] = handle;
+        return;
+    }
+
+    // Each texture gets its own GPU texture so the draws are batched the same as in the captured frames, the contents don't matter
+    GPUTexture* gpuTexture = GPUDevice::Instance->CreateTexture(TEXT("RmlUi.ReplayTexture"));
+    if (gpuTexture->Init(GPUTextureDescription::New2D(Math::Max(width, 1), Math::Max(height, 1), isSdf ? PixelFormat::R8_UNorm : PixelFormat::B8G8R8A8_UNorm)))
+    {
+        SAFE_DELETE_GPU_RESOURCE(gpuTexture);
+        LOG(Warning, "RmlUi: Failed to create replay texture {0}x{1}", width, height);
+        return;
+    }
+    ReplayAllocatedTextures.Add(gpuTexture);
+    handle = isSdf ? renderInterface->RegisterSdfTexture(gpuTexture, sdfParams) : renderInterface->RegisterTexture(gpuTexture, isFont);
+    ReplayTextureHandles[texture] = handle;
+    ReplayTextures[texture] = handle;
+}
+
+bool ReadGeometry(CaptureReader& reader, Rml::TextureHandle& texture, int32& numVertices, int32& numIndices)
+{
+    texture = ReplayTexture(reader.Read<uint64>());
+    numVertices = reader.Read<int32>();
+    numIndices = reader.Read<int32>();
+    if (!reader.IsValid() || numVertices < 0 || numIndices < 0)
+        return false;
+    ReplayVertices.Resize(numVertices, false);
+    ReplayIndices.Resize(numIndices, false);
+    return reader.Read(ReplayVertices.Get(), numVertices * (int32)sizeof(Rml::Vertex)) && reader.Read(ReplayIndices.Get(), numIndices * (int32)sizeof(int));
+}
+
+// Releases the geometry created by the replayed commands and forgets the defined textures, so the next iteration starts the same as the capture
+void ReleaseReplayResources(FlaxRenderInterface* renderInterface)
+{
+    for (const Rml::CompiledGeometryHandle geometry : ReplayCompiledGeometries)
+        renderInterface->ReleaseCompiledGeometry(geometry);
+    ReplayCompiledGeometries.Clear();
+    ReplayGeometries.Clear();
+    ReplayTextures.Clear();
+}
+
+// Unregisters the textures created for the replay, unregistered handles are never reused so this is done once per replay
+void ReleaseReplayTextures(FlaxRenderInterface* renderInterface)
+{
+    for (const auto& e : ReplayTextureHandles)
+        renderInterface->UnregisterTexture(e.Value);
+    ReplayTextureHandles.Clear();
+    for (GPUTexture*& texture : ReplayAllocatedTextures)
+        SAFE_DELETE_GPU_RESOURCE(texture);
+    ReplayAllocatedTextures.Clear();
+}
+
+void FinishReplay(FlaxRenderInterface* renderInterface)
+{
+    ReleaseReplayResources(renderInterface);
+    ReleaseReplayTextures(renderInterface);
+    Replaying = false;
+    ReplayData.Resize(0);
+
+    const int32 frames = Math::Max(ReplayResult.Frames, 1);
+    ReplayResult.RenderTime = ReplayResult.RenderTime * 1000.0 / frames;
+    ReplayResult.CompileGeometryTime = ReplayResult.CompileGeometryTime * 1000.0 / frames;
+    ReplayResult.DrawCalls /= frames;
+    ReplayResult.Vertices /= frames;
+    ReplayResult.Indices /= frames;
+    LOG(Info, "RmlUi: Replayed {0} frames: render {1} ms, {2} draw calls, {3} vertices, {4} missing geometries",
+        ReplayResult.Frames, ReplayResult.RenderTime, ReplayResult.DrawCalls, ReplayResult.Vertices, ReplayResult.MissingGeometries);
+    RmlUiRenderCapture::ReplayCompleted(ReplayResult);
+}
+
+// Executes the captured commands up to the end of the next frame, returns false at the end of the capture
+bool ReplayCommands(FlaxRenderInterface* renderInterface, RenderContext* renderContext, GPUContext* gpuContext)
+{
+    PROFILE_CPU_NAMED("RmlUi.ReplayFrame");
+
+    CaptureReader& reader = ReplayReader;
+    double frameStart = 0.0;
+    while (reader.position < reader.size)
+    {
+        const CaptureCommand command = (CaptureCommand)reader.Read<byte>();
+        switch (command)
+        {
+        case CaptureCommand::BeginFrame:
+        {
+            const float width = reader.Read<float>();
+            const float height = reader.Read<float>();
+            frameStart = Platform::GetTimeSeconds();
+            renderInterface->Begin(renderContext, gpuContext, Viewport(0, 0, width, height));
+            break;
+        }
+        case CaptureCommand::BeginContext:
+            renderInterface->BeginContext(reader.Read<int32>());
+            break;
+        case CaptureCommand::EndFrame:
+        {
+            renderInterface->End();
+            const FlaxRenderStats& stats = renderInterface->GetStats();
+            ReplayResult.Frames++;
+            ReplayResult.RenderTime += Platform::GetTimeSeconds() - frameStart;
+            ReplayResult.CompileGeometryTime += stats.CompileTime;
+            ReplayResult.DrawCalls += (float)stats.DrawCalls;
+            ReplayResult.Vertices += (float)stats.Vertices;
+            ReplayResult.Indices += (float)stats.Indices;
+            return true;
+        }
+        case CaptureCommand::RenderGeometry:
+        {
+            const Rml::Vector2f translation = reader.Read<Rml::Vector2f>();
+            Rml::TextureHandle texture;
+            int32 numVertices, numIndices;
+            if (ReadGeometry(reader, texture, numVertices, numIndices))
+                renderInterface->RenderGeometry(ReplayVertices.Get(), numVertices, ReplayIndices.Get(), numIndices, texture, translation);
+            break;
+        }
+        case CaptureCommand::CompileGeometry:
+        {
+            const uint64 geometry = reader.Read<uint64>();
+            Rml::TextureHandle texture;
+            int32 numVertices, numIndices;
+            if (ReadGeometry(reader, texture, numVertices, numIndices))
+            {
+                const Rml::CompiledGeometryHandle handle = renderInterface->CompileGeometry(ReplayVertices.Get(), numVertices, ReplayIndices.Get(), numIndices, texture);
+                ReplayGeometries[geometry] = handle;
+                ReplayCompiledGeometries.Add(handle);
+            }
+            break;
+        }
+        case CaptureCommand::RenderCompiledGeometry:
+        {
+            const uint64 geometry = reader.Read<uint64>();
+            const Rml::Vector2f translation = reader.Read<Rml::Vector2f>();
+            Rml::CompiledGeometryHandle handle;
+            if (ReplayGeometries.TryGet(geometry, handle))
+                renderInterface->RenderCompiledGeometry(handle, translation);
+            else
+                ReplayResult.MissingGeometries++;
+            break;
+        }
+        case CaptureCommand::ReleaseCompiledGeometry:
+        {
+            // Identical geometry shares the handle, the mapping is kept until all of its compilations are released
+            Rml::CompiledGeometryHandle handle;
+            if (ReplayGeometries.TryGet(reader.Read<uint64>(), handle) && ReplayCompiledGeometries.Remove(handle))
+                renderInterface->ReleaseCompiledGeometry(handle);
+            break;
+        }
+        case CaptureCommand::EnableScissorRegion:
+            renderInterface->EnableScissorRegion(reader.Read<bool>());
+            break;
+        case CaptureCommand::SetScissorRegion:
+        {
+            const int32 x = reader.Read<int32>();
+            const int32 y = reader.Read<int32>();
+            const int32 width = reader.Read<int32>();
+            const int32 height = reader.Read<int32>();
+            renderInterface->SetScissorRegion(x, y, width, height);
+            break;
+        }
+        case CaptureCommand::SetTransform:
+        {
+            if (!reader.Read<bool>())
+            {
+                renderInterface->SetTransform(nullptr);
+                break;
+            }
+            Rml::Matrix4f transform;
+            reader.Read(transform.data(), 16 * sizeof(float));
+            renderInterface->SetTransform(&transform);
+            break;
+        }
+        case CaptureCommand::DefineTexture:
+        {
+            const uint64 texture = reader.Read<uint64>();
+            const int32 width = reader.Read<int32>();
+            const int32 height = reader.Read<int32>();
+            const bool isFont = reader.Read<bool>();
+            const bool isSdf = reader.Read<bool>();
+            const Float2 sdfParams = reader.Read<Float2>();
+            DefineReplayTexture(renderInterface, texture, width, height, isFont, isSdf, sdfParams);
+            break;
+        }
+        case CaptureCommand::ReleaseTexture:
+        {
+            // The texture stays registered for the next iterations until the replay finishes
+            ReplayTextures.Remove(reader.Read<uint64>());
+            break;
+        }
+        default:
+            reader.position = reader.size + 1;
+            break;
+        }
+
+        if (!reader.IsValid())
+        {
+            LOG(Error, "RmlUi: Render capture is corrupted");
+            return false;
+        }
+    }
+
+    // Start the next iteration from the first frame, the first command after the header
+    if (--ReplayIterations <= 0)
+        return false;
+    ReleaseReplayResources(renderInterface);
+    reader.position = sizeof(CaptureHeader);
+    return true;
+}
+
+bool RmlUiRenderCapture::Replay(const StringView& path, int32 iterations)
+{
+    if (!RmlUiPlugin::IsInitialized() || Capturing || Replaying)
+    {
+        LOG(Warning, "RmlUi: Render capture replay requires RmlUi to be initialized and not capturing");
+        return true;
+    }
+
+    if (File::ReadAllBytes(path, ReplayData))
+    {
+        LOG(Error, "RmlUi: Failed to read render capture from {0}", path);
+        return true;
+    }
+    CaptureHeader header;
+    if (ReplayData.Count() < (int32)sizeof(CaptureHeader))
+        header.magic = 0;
+    else
+        Platform::MemoryCopy(&header, ReplayData.Get(), sizeof(CaptureHeader));
+    if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION)
+    {
+        LOG(Error, "RmlUi: File {0} is not a supported render capture", path);
+        ReplayData.Resize(0);
+        return true;
+    }
+
+    ReplayReader.data = ReplayData.Get();
+    ReplayReader.size = ReplayData.Count();
+    ReplayReader.position = sizeof(CaptureHeader);
+    ReplayIterations = Math::Max(iterations, 1);
+    ReplayResult = RmlUiCaptureReplayResult();
+    Replaying = true;
+
+    // Running headless there is no frame to wait for
+    if (RmlUiPlugin::IsHeadless())
+    {
+        FlaxRenderInterface* renderInterface = GetFlaxRenderInterface();
+        while (ReplayCommands(renderInterface, nullptr, nullptr))
+        {
+        }
+        FinishReplay(renderInterface);
+    }
+    return false;
+}
+
+bool RmlUiRenderCapture::IsReplaying()
+{
+    return Replaying;
+}
+
+void RmlUiRenderCapture::ReplayFrame(RenderContext* renderContext, GPUContext* gpuContext)
+{
+    FlaxRenderInterface* renderInterface = GetFlaxRenderInterface();
+    if (!ReplayCommands(renderInterface, renderContext, gpuContext))
+        FinishReplay(renderInterface);
+}
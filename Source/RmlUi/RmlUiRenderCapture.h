@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <ThirdParty/RmlUi/Core/RenderInterface.h>
+
+#include <Engine/Core/Delegate.h>
+#include <Engine/Core/Math/Viewport.h>
+#include <Engine/Core/Types/StringView.h>
+#include <Engine/Scripting/ScriptingType.h>
+
+struct RenderContext;
+class GPUContext;
+
+/// <summary>
+/// Measurements of replaying a render capture. Times are in milliseconds and, like the counters, averaged per replayed frame.
+/// </summary>
+API_STRUCT() struct RMLUI_API RmlUiCaptureReplayResult
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(RmlUiCaptureReplayResult);
+
+    /// <summary>
+    /// The number of replayed frames, including all iterations.
+    /// </summary>
+    API_FIELD() int32 Frames = 0;
+
+    /// <summary>
+    /// The time of executing the captured commands of a frame, including submitting the draw calls.
+    /// </summary>
+    API_FIELD() double RenderTime = 0;
+
+    /// <summary>
+    /// The time of compiling geometry.
+    /// </summary>
+    API_FIELD() double CompileGeometryTime = 0;
+
+    /// <summary>
+    /// The number of submitted draw calls.
+    /// </summary>
+    API_FIELD() float DrawCalls = 0;
+
+    /// <summary>
+    /// The number of submitted vertices.
+    /// </summary>
+    API_FIELD() float Vertices = 0;
+
+    /// <summary>
+    /// The number of submitted indices.
+    /// </summary>
+    API_FIELD() float Indices = 0;
+
+    /// <summary>
+    /// The number of draws of geometry which was compiled before the capture started and couldn't be replayed.
+    /// </summary>
+    API_FIELD() int32 MissingGeometries = 0;
+};
+
+/// <summary>
+/// Captures the calls RmlUi makes to the render interface into a binary file and replays them against the render interface RmlUi is running with,
+/// so changes of the render path can be measured on exact frames without the game content. Textures are captured only as their dimensions and kind,
+/// the replay draws with uninitialized textures of the same size.
+/// </summary>
+API_CLASS(Static) class RMLUI_API RmlUiRenderCapture
+{
+    DECLARE_SCRIPTING_TYPE_NO_SPAWN(RmlUiRenderCapture);
+
+public:
+    /// <summary>
+    /// Starts capturing the next rendered frames. All compiled geometry is released so the geometry rendered by the frames is compiled again within the capture.
+    /// </summary>
+    /// <param name="path">The path of the written capture file.</param>
+    /// <param name="frames">The number of captured frames, the capture is written after the last frame.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() static bool StartCapture(const StringView& path, int32 frames);
+
+    /// <summary>
+    /// Stops capturing and writes the frames captured so far.
+    /// </summary>
+    API_FUNCTION() static void StopCapture();
+
+    /// <summary>
+    /// Returns true while the frames are captured.
+    /// </summary>
+    API_FUNCTION() static bool IsCapturing();
+
+    /// <summary>
+    /// Replays the capture. Running headless the capture is replayed before returning, otherwise the captured frames are rendered instead of the canvases on the next frames.
+    /// </summary>
+    /// <param name="path">The path of the capture file.</param>
+    /// <param name="iterations">The number of times all captured frames are replayed.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() static bool Replay(const StringView& path, int32 iterations = 1);
+
+    /// <summary>
+    /// Returns true while the capture is replayed.
+    /// </summary>
+    API_FUNCTION() static bool IsReplaying();
+
+    /// <summary>
+    /// Occurs when the replay of a capture is completed.
+    /// </summary>
+    API_EVENT() static Delegate<const RmlUiCaptureReplayResult&> ReplayCompleted;
+
+public:
+    /// <summary>
+    /// Renders the next captured frame, called by the plugin instead of rendering the canvases while replaying.
+    /// </summary>
+    static void ReplayFrame(RenderContext* renderContext, GPUContext* gpuContext);
+
+    static void CaptureBeginFrame(const Viewport& viewport);
+    static void CaptureBeginContext(int32 contextIndex);
+    static void CaptureEndFrame();
+    static void CaptureRenderGeometry(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture, const Rml::Vector2f& translation);
+    static void CaptureCompileGeometry(const Rml::Vertex* vertices, int num_vertices, const int* indices, int num_indices, Rml::TextureHandle texture, Rml::CompiledGeometryHandle geometry);
+    static void CaptureRenderCompiledGeometry(Rml::CompiledGeometryHandle geometry, const Rml::Vector2f& translation);
+    static void CaptureReleaseCompiledGeometry(Rml::CompiledGeometryHandle geometry);
+    static void CaptureEnableScissorRegion(bool enable);
+    static void CaptureSetScissorRegion(int x, int y, int width, int height);
+    static void CaptureSetTransform(const Rml::Matrix4f* transform);
+    static void CaptureTexture(Rml::TextureHandle texture);
+    static void CaptureReleaseTexture(Rml::TextureHandle texture);
+};
@@ -0,0 +1,302 @@
+﻿#include "RmlUiTrace.h"
+#include "RmlUiPlugin.h"
+
+#include <Engine/Core/Collections/Array.h>
+#include <Engine/Core/Log.h>
+#include <Engine/Core/Types/DateTime.h>
+#include <Engine/Engine/Globals.h>
+#include <Engine/Platform/File.h>
+#include <Engine/Platform/FileSystem.h>
+#include <Engine/Platform/Platform.h>
+#include <Engine/Serialization/JsonWriters.h>
+
+// Chrome trace timestamps are in microseconds
+#define TRACE_TIME_SCALE 1000000.0
+
+namespace
+{
+    struct TraceEvent
+    {
+        const Char* name;
+        double start;
+        double end;
+        int32 depth;
+        int32 canvas;
+        String detail;
+    };
+
+    struct TraceFrame
+    {
+        uint64 index = 0;
+        double start = 0;
+        double uiTime = 0;
+        Array<TraceEvent> events;
+        Array<String> canvases;
+    };
+
+    Array<TraceFrame> TraceFrames;
+    int32 CurrentFrame = 0;
+    uint64 FrameIndex = 0;
+    int32 FramesSinceDump = 0;
+    int32 EventDepth = 0;
+    int32 CurrentCanvas = -1;
+    float FrameBudget = 0.0f;
+    String LastDumpPath;
+}
+
+bool RmlUiTrace::Recording = false;
+
+void RmlUiTrace::Start(int32 frames, float frameBudget)
+{
+    Stop();
+    if (frames <= 0)
+        return;
+
+    TraceFrames.Resize(frames);
+    CurrentFrame = 0;
+    FrameIndex = 0;
+    FramesSinceDump = frames;
+    EventDepth = 0;
+    CurrentCanvas = -1;
+    FrameBudget = frameBudget;
+    Recording = true;
+}
+
+void RmlUiTrace::Stop()
+{
+    Recording = false;
+    TraceFrames.Resize(0);
+}
+
+bool RmlUiTrace::Dump(const StringView& path)
+{
+    if (!Recording)
+    {
+        LOG(Warning, "RmlUi: The trace is not recorded");
+        return true;
+    }
+
+    rapidjson_flax::StringBuffer buffer;
+    CompactJsonWriter writer(buffer);
+    writer.StartObject();
+    writer.JKEY("displayTimeUnit");
+    writer.String("ms");
+    writer.JKEY("otherData");
+    writer.StartObject();
+    writer.JKEY("version");
+    writer.String(RMLUI_PLUGIN_VERSION.ToString());
+    writer.EndObject();
+    writer.JKEY("traceEvents");
+    writer.StartArray();
+
+    // The frames are shown on a separate track above the events
+    const Char* trackNames[] = { TEXT("Frames"), TEXT("RmlUi") };
+    for (int32 track = 0; track < ARRAY_COUNT(trackNames); track++)
+    {
+        writer.StartObject();
+        writer.JKEY("name");
+        writer.String("thread_name");
+        writer.JKEY("ph");
+        writer.String("M");
+        writer.JKEY("pid");
+        writer.Int(0);
+        writer.JKEY("tid");
+        writer.Int(track);
+        writer.JKEY("args");
+        writer.StartObject();
+        writer.JKEY("name");
+        writer.String(trackNames[track]);
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    // Frames are written from the oldest, the current frame ends now
+    const double now = Platform::GetTimeSeconds();
+    double origin = -1.0;
+    for (int32 i = 1; i <= TraceFrames.Count(); i++)
+    {
+        const TraceFrame& frame = TraceFrames[(CurrentFrame + i) % TraceFrames.Count()];
+        if (frame.index == 0)
+            continue;
+        if (origin < 0.0)
+            origin = frame.start;
+        const TraceFrame& nextFrame = TraceFrames[(CurrentFrame + i + 1) % TraceFrames.Count()];
+        const double frameEnd = i == TraceFrames.Count() || nextFrame.index != frame.index + 1 ? now : nextFrame.start;
+
+        writer.StartObject();
+        writer.JKEY("name");
+        writer.String(String::Format(TEXT("Frame {0}"), frame.index));
+        writer.JKEY("cat");
+        writer.String("Frame");
+        writer.JKEY("ph");
+        writer.String("X");
+        writer.JKEY("ts");
+        writer.Double((frame.start - origin) * TRACE_TIME_SCALE);
+        writer.JKEY("dur");
+        writer.Double((frameEnd - frame.start) * TRACE_TIME_SCALE);
+        writer.JKEY("pid");
+        writer.Int(0);
+        writer.JKEY("tid");
+        writer.Int(0);
+        writer.JKEY("args");
+        writer.StartObject();
+        writer.JKEY("uiTime");
+        writer.Double(frame.uiTime * 1000.0);
+        writer.EndObject();
+        writer.EndObject();
+
+        for (const TraceEvent& e : frame.events)
+        {
+            // Events still open in the current frame are skipped
+            if (e.end < e.start)
+                continue;
+
+            writer.StartObject();
+            writer.JKEY("name");
+            writer.String(e.name);
+            writer.JKEY("cat");
+            writer.String("RmlUi");
+            writer.JKEY("ph");
+            writer.String("X");
+            writer.JKEY("ts");
+            writer.Double((e.start - origin) * TRACE_TIME_SCALE);
+            writer.JKEY("dur");
+            writer.Double((e.end - e.start) * TRACE_TIME_SCALE);
+            writer.JKEY("pid");
+            writer.Int(0);
+            writer.JKEY("tid");
+            writer.Int(1);
+            if (e.canvas != -1 || e.detail.HasChars())
+            {
+                writer.JKEY("args");
+                writer.StartObject();
+                if (e.canvas != -1)
+                {
+                    writer.JKEY("canvas");
+                    writer.String(frame.canvases[e.canvas]);
+                }
+                if (e.detail.HasChars())
+                {
+                    writer.JKEY("detail");
+                    writer.String(e.detail);
+                }
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    const String directory = StringUtils::GetDirectoryName(path);
+    if (directory.HasChars() && !FileSystem::DirectoryExists(directory) && FileSystem::CreateDirectory(directory))
+    {
+        LOG(Error, "RmlUi: Failed to create the trace directory {0}", directory);
+        return true;
+    }
+    if (File::WriteAllBytes(path, buffer.GetString(), (int32)buffer.GetSize()))
+    {
+        LOG(Error, "RmlUi: Failed to write the trace to {0}", path);
+        return true;
+    }
+    return false;
+}
+
+String RmlUiTrace::GetLastDumpPath()
+{
+    return LastDumpPath;
+}
+
+void RmlUiTrace::BeginFrame()
+{
+    if (!Recording)
+        return;
+
+    FramesSinceDump++;
+    const TraceFrame& lastFrame = TraceFrames[CurrentFrame];
+    if (FrameBudget > 0.0f && lastFrame.index != 0 && lastFrame.uiTime * 1000.0 > FrameBudget && FramesSinceDump >= TraceFrames.Count())
+    {
+        // Dump the frames leading to the slow frame, the following frames are only dumped when they exceed the budget again after a full rolling window
+        const String path = Globals::ProductLocalFolder / TEXT("RmlUiTraces") / String::Format(TEXT("RmlUiTrace_{0}_{1}.json"), DateTime::Now().ToFileNameString(), lastFrame.index);
+        LOG(Warning, "RmlUi: Frame {0} took {1} ms, over the budget of {2} ms, writing the trace to {3}", lastFrame.index, (float)(lastFrame.uiTime * 1000.0), FrameBudget, path);
+        if (!Dump(path))
+            LastDumpPath = path;
+        FramesSinceDump = 0;
+    }
+
+    // The arrays of the reused frame keep their capacity
+    CurrentFrame = (CurrentFrame + 1) % TraceFrames.Count();
+    TraceFrame& frame = TraceFrames[CurrentFrame];
+    frame.index = ++FrameIndex;
+    frame.start = Platform::GetTimeSeconds();
+    frame.uiTime = 0;
+    frame.events.Clear();
+    frame.canvases.Clear();
+    EventDepth = 0;
+    CurrentCanvas = -1;
+}
+
+void RmlUiTrace::SetCanvas(const StringView& name)
+{
+    if (!Recording)
+        return;
+
+    CurrentCanvas = -1;
+    if (name.IsEmpty())
+        return;
+
+    Array<String>& canvases = TraceFrames[CurrentFrame].canvases;
+    for (int32 i = 0; i < canvases.Count() && CurrentCanvas == -1; i++)
+    {
+        if (canvases[i] == name)
+            CurrentCanvas = i;
+    }
+    if (CurrentCanvas == -1)
+    {
+        CurrentCanvas = canvases.Count();
+        canvases.Add(String(name));
+    }
+}
+
+int32 RmlUiTrace::BeginEvent(const Char* name)
+{
+    // Events of the worker threads would break the nesting of the single track
+    if (Platform::GetCurrentThreadID() != Globals::MainThreadID)
+        return -1;
+
+    Array<TraceEvent>& events = TraceFrames[CurrentFrame].events;
+    TraceEvent& e = events.AddOne();
+    e.name = name;
+    e.start = Platform::GetTimeSeconds();
+    e.end = -1.0;
+    e.depth = EventDepth++;
+    e.canvas = CurrentCanvas;
+    e.detail.Clear();
+    return events.Count() - 1;
+}
+
+void RmlUiTrace::EndEvent(int32 eventIndex)
+{
+    // The recording may have been restarted or stopped by a nested event
+    if (!Recording)
+        return;
+    Array<TraceEvent>& events = TraceFrames[CurrentFrame].events;
+    if (eventIndex >= events.Count())
+        return;
+
+    TraceEvent& e = events[eventIndex];
+    e.end = Platform::GetTimeSeconds();
+    EventDepth = e.depth;
+    if (e.depth == 0)
+        TraceFrames[CurrentFrame].uiTime += e.end - e.start;
+}
+
+void RmlUiTrace::SetEventDetail(int32 eventIndex, const StringView& detail)
+{
+    if (!Recording)
+        return;
+    Array<TraceEvent>& events = TraceFrames[CurrentFrame].events;
+    if (eventIndex < events.Count())
+        events[eventIndex].detail = detail;
+}
@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <Engine/Core/Types/String.h>
+#include <Engine/Core/Types/StringView.h>
+#include <Engine/Scripting/ScriptingType.h>
+
+/// <summary>
+/// Rolling trace of the RmlUi profiler events of the last frames, written in the Chrome trace event format which can be opened in Perfetto or chrome://tracing.
+/// Events are recorded regardless of the instrumentation level.
+/// </summary>
+API_CLASS(Static) class RMLUI_API RmlUiTrace
+{
+    DECLARE_SCRIPTING_TYPE_NO_SPAWN(RmlUiTrace);
+
+public:
+    /// <summary>
+    /// Starts recording the events of the last frames, restarting the recording when already started.
+    /// </summary>
+    /// <param name="frames">The number of the last frames kept in the trace.</param>
+    /// <param name="frameBudget">The RmlUi time of a single frame in milliseconds above which the trace is dumped to the product local folder, at most once per the number of kept frames. Not dumped automatically when zero.</param>
+    API_FUNCTION() static void Start(int32 frames, float frameBudget);
+
+    /// <summary>
+    /// Stops recording and releases the recorded frames.
+    /// </summary>
+    API_FUNCTION() static void Stop();
+
+    /// <summary>
+    /// Writes the recorded frames to the file.
+    /// </summary>
+    /// <param name="path">The path of the written JSON file.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() static bool Dump(const StringView& path);
+
+    /// <summary>
+    /// Gets the path of the last trace dumped after exceeding the frame budget, empty when none was dumped.
+    /// </summary>
+    API_FUNCTION() static String GetLastDumpPath();
+
+    static bool IsRecording()
+    {
+        return Recording;
+    }
+
+    /// <summary>
+    /// Starts the next frame, dumping the trace when the finished frame exceeded the budget. Called before the canvases are updated.
+    /// </summary>
+    static void BeginFrame();
+
+    /// <summary>
+    /// Sets the name of the canvas the following events are annotated with, empty to stop annotating.
+    /// </summary>
+    static void SetCanvas(const StringView& name);
+
+    static int32 BeginEvent(const Char* name);
+    static void EndEvent(int32 eventIndex);
+    static void SetEventDetail(int32 eventIndex, const StringView& detail);
+
+private:
+    static bool Recording;
+};
@@ -1,5 +1,16 @@
 #include "./Flax/GUICommon.hlsl"
 
+// Shading mode stored in each vertex
+#define DRAW_MODE_COLOR 0
+#define DRAW_MODE_IMAGE 1
+#define DRAW_MODE_FONT 2
+#define DRAW_MODE_SDF 3
+
+// Geometry which lies fully inside of its clip rectangle skips the per-pixel clipping
+#ifndef CLIPPING_ENABLE
+#define CLIPPING_ENABLE 0
+#endif
+
 struct BasicVertex
 {
     float2 Position : POSITION0;
@@ -7,60 +18,159 @@ struct BasicVertex
     float4 Color : COLOR0;
     float2 ClipOrigin : TEXCOORD1;
     float4 ClipExtents : TEXCOORD2;
+    float4 Params : TEXCOORD3;
+};
+
+struct BasicVS2PS
+{
+    float4 Position : SV_Position;
+    float4 Color : COLOR0;
+    float2 TexCoord : TEXCOORD0;
+    float4 Params : TEXCOORD1;
+#if CLIPPING_ENABLE
+    float4 ClipOriginAndPos : TEXCOORD2;
+    float4 ClipExtents : TEXCOORD3;
+#endif
+};
+
+struct GlyphVertex
+{
+    float2 Corner : POSITION0;
+    float4 Rect : TEXCOORD0;
+    float4 UVRect : TEXCOORD1;
+    float4 Color : COLOR0;
 };
 
 META_CB_BEGIN(0, Data)
 float4x4 ViewProjection;
 float4x4 Model;
 float2 Offset;
-float2 Dummy1;
+float2 SdfParams;
 META_CB_END
 
 Texture2D Image : register(t0);
+Texture2D Image1 : register(t1);
+Texture2D Image2 : register(t2);
+Texture2D Image3 : register(t3);
+Texture2D Image4 : register(t4);
+Texture2D Image5 : register(t5);
+Texture2D Image6 : register(t6);
+Texture2D Image7 : register(t7);
 
 META_VS(true, FEATURE_LEVEL_ES2)
+META_PERMUTATION_1(CLIPPING_ENABLE=0)
+META_PERMUTATION_1(CLIPPING_ENABLE=1)
 META_VS_IN_ELEMENT(POSITION, 0, R32G32_FLOAT,       0, ALIGN, PER_VERTEX, 0, true)
 META_VS_IN_ELEMENT(TEXCOORD, 0, R16G16_FLOAT,       0, ALIGN, PER_VERTEX, 0, true)
 META_VS_IN_ELEMENT(COLOR,    0, R32G32B32A32_FLOAT, 0, ALIGN, PER_VERTEX, 0, true)
-META_VS_IN_ELEMENT(TEXCOORD, 1, R32G32_FLOAT,       0, 0,     PER_VERTEX, 0, true)
+META_VS_IN_ELEMENT(TEXCOORD, 1, R32G32_FLOAT,       0, ALIGN, PER_VERTEX, 0, true)
 META_VS_IN_ELEMENT(TEXCOORD, 2, R32G32B32A32_FLOAT, 0, ALIGN, PER_VERTEX, 0, true)
-VS2PS VS(BasicVertex input)
+META_VS_IN_ELEMENT(TEXCOORD, 3, R16G16B16A16_FLOAT, 0, ALIGN, PER_VERTEX, 0, true)
+BasicVS2PS VS(BasicVertex input)
 {
-    VS2PS output;
+    BasicVS2PS output;
 
-    output.Position = mul(mul(float4(input.Position + Offset, 0, 1), Model), ViewProjection);
+    // Clip rectangles are in screen space, test against the transformed position
+    float4 position = mul(float4(input.Position + Offset, 0, 1), Model);
+    output.Position = mul(position, ViewProjection);
     output.Color = input.Color;
     output.TexCoord = input.TexCoord;
-    output.ClipOriginAndPos = float4(input.ClipOrigin.xy, input.Position);
+    output.Params = input.Params;
+#if CLIPPING_ENABLE
+    output.ClipOriginAndPos = float4(input.ClipOrigin.xy, position.xy / position.w);
     output.ClipExtents = input.ClipExtents;
-    output.CustomData = input.ClipOrigin.xy;
+#endif
 
     return output;
 }
 
-META_PS(true, FEATURE_LEVEL_ES2)
-float4 PS_Image(VS2PS input) : SV_Target0
+META_VS(true, FEATURE_LEVEL_ES2)
+META_VS_IN_ELEMENT(POSITION, 0, R32G32_FLOAT,       0, ALIGN, PER_VERTEX,   0, true)
+META_VS_IN_ELEMENT(TEXCOORD, 0, R32G32B32A32_FLOAT, 1, 0,     PER_INSTANCE, 1, true)
+META_VS_IN_ELEMENT(TEXCOORD, 1, R16G16B16A16_FLOAT, 1, ALIGN, PER_INSTANCE, 1, true)
+META_VS_IN_ELEMENT(COLOR,    0, R8G8B8A8_UNORM,     1, ALIGN, PER_INSTANCE, 1, true)
+BasicVS2PS VS_Glyph(GlyphVertex input)
 {
-    PerformClipping(input);
+    BasicVS2PS output;
+
+    // Expand the glyph quad from the instance rectangle, glyphs are clipped only by the scissor rectangle
+    float2 position = input.Rect.xy + input.Corner * input.Rect.zw;
+    output.Position = mul(mul(float4(position + Offset, 0, 1), Model), ViewProjection);
+    output.Color = input.Color;
+    output.TexCoord = lerp(input.UVRect.xy, input.UVRect.zw, input.Corner);
+    output.Params = float4(0, 0, 0, 0);
 
-    return Image.Sample(SamplerLinearClamp, input.TexCoord) * input.Color;
+    return output;
 }
 
-META_PS(true, FEATURE_LEVEL_ES2)
-float4 PS_Color(VS2PS input) : SV_Target0
+float4 ShadeBasic(BasicVS2PS input, float4 sample)
 {
-    //PerformClipping(input);
+#if CLIPPING_ENABLE
+    PerformClipping(input.ClipOriginAndPos.xy, input.ClipOriginAndPos.zw, input.ClipExtents);
+#endif
 
-	float4 color = input.Color;
+    // Untextured geometry is drawn with a white texture bound
+    float4 color = input.Color;
+    int mode = (int)round(input.Params.x);
+    if (mode == DRAW_MODE_IMAGE)
+    {
+        color *= sample;
+    }
+    else if (mode == DRAW_MODE_FONT)
+    {
+        color.a *= sample.r;
+    }
+    else if (mode == DRAW_MODE_SDF)
+    {
+        // Params.y is the distance of the edge, Params.z is the half-width of the edge transition
+        color.a *= smoothstep(input.Params.y - input.Params.z, input.Params.y + input.Params.z, sample.r);
+    }
     return color;
 }
 
 META_PS(true, FEATURE_LEVEL_ES2)
-float4 PS_Font(VS2PS input) : SV_Target0
+META_PERMUTATION_1(CLIPPING_ENABLE=0)
+META_PERMUTATION_1(CLIPPING_ENABLE=1)
+float4 PS(BasicVS2PS input) : SV_Target0
+{
+    return ShadeBasic(input, Image.Sample(SamplerLinearClamp, input.TexCoord));
+}
+
+META_PS(true, FEATURE_LEVEL_SM4)
+META_PERMUTATION_1(CLIPPING_ENABLE=0)
+META_PERMUTATION_1(CLIPPING_ENABLE=1)
+float4 PS_MultiTexture(BasicVS2PS input) : SV_Target0
 {
-    PerformClipping(input);
+    // Params.w is the texture slot of the draw within the batch
+    float4 sample;
+    switch ((int)round(input.Params.w))
+    {
+    case 1: sample = Image1.Sample(SamplerLinearClamp, input.TexCoord); break;
+    case 2: sample = Image2.Sample(SamplerLinearClamp, input.TexCoord); break;
+    case 3: sample = Image3.Sample(SamplerLinearClamp, input.TexCoord); break;
+    case 4: sample = Image4.Sample(SamplerLinearClamp, input.TexCoord); break;
+    case 5: sample = Image5.Sample(SamplerLinearClamp, input.TexCoord); break;
+    case 6: sample = Image6.Sample(SamplerLinearClamp, input.TexCoord); break;
+    case 7: sample = Image7.Sample(SamplerLinearClamp, input.TexCoord); break;
+    default: sample = Image.Sample(SamplerLinearClamp, input.TexCoord); break;
+    }
+    return ShadeBasic(input, sample);
+}
 
+META_PS(true, FEATURE_LEVEL_ES2)
+float4 PS_Font(BasicVS2PS input) : SV_Target0
+{
     float4 color = input.Color;
     color.a *= Image.Sample(SamplerLinearClamp, input.TexCoord).r;
     return color;
-}
\ No newline at end of file
+}
+
+META_PS(true, FEATURE_LEVEL_ES2)
+float4 PS_FontSdf(BasicVS2PS input) : SV_Target0
+{
+    // SdfParams.x is the distance of the edge, SdfParams.y is the half-width of the edge transition
+    float distance = Image.Sample(SamplerLinearClamp, input.TexCoord).r;
+    float4 color = input.Color;
+    color.a *= smoothstep(SdfParams.x - SdfParams.y, SdfParams.x + SdfParams.y, distance);
+    return color;
+}